@@ -0,0 +1,93 @@
+// Native shim: Arduino core subset for running the firmware on a workstation
+#pragma once
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <functional>
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW  0
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+#define RISING       0x01
+#define FALLING      0x02
+#define CHANGE       0x03
+
+#define IRAM_ATTR
+#define digitalPinToInterrupt(p) (p)
+
+#define PROGMEM
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+// Level changes made with nativeSetPin() call the ISR on the stdin thread
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode);
+void detachInterrupt(uint8_t pin);
+
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+// PSRAM: the host has plenty, report it as fitted
+bool psramFound();
+void* ps_malloc(size_t size);
+bool setCpuFrequencyMhz(uint32_t mhz);
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 38))
+#define NATIVE_HAS_STRLCPY 1 // glibc ships strlcpy/strlcat since 2.38
+#else
+size_t strlcpy(char* dst, const char* src, size_t size);
+size_t strlcat(char* dst, const char* src, size_t size);
+#endif
+
+// Serial: stdout for output; stdin lines not starting with '!' are readable input
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    size_t setTxBufferSize(size_t size) { return size; }
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    int available() override;
+    int read() override;
+    int peek() override;
+    // Called on the stdin thread after each input line is queued
+    void onReceive(std::function<void(void)> fn, bool onlyOnTimeout = false);
+    using Print::write;
+};
+extern HardwareSerial Serial;
+
+class EspClass {
+public:
+    [[noreturn]] void restart();
+    // Fixed figures: the host heap has nothing to say about the ESP32's
+    uint32_t getFreeHeap();
+    uint32_t getMinFreeHeap();
+    uint32_t getPsramSize();
+    uint32_t getFreePsram();
+    uint32_t getMinFreePsram();
+};
+extern EspClass ESP;
+
+// --- Native-only hooks (harness control) ---
+// stdin lines starting with '!' drive the simulated hardware:
+//   !pin <n> <0|1>   set GPIO level (buttons are active LOW)
+//   !dump <file>     write the framebuffer as a PPM image
+//   !quit            exit
+void nativeSetPin(uint8_t pin, int level);
@@ -0,0 +1,38 @@
+// Native shim: Button2 polling the simulated GPIO levels (see nativeSetPin)
+#pragma once
+#include <Arduino.h>
+
+class Button2 {
+public:
+    typedef void (*CallbackFunction)(Button2&);
+
+    void begin(uint8_t pin, uint8_t mode = INPUT_PULLUP, bool activeLow = true);
+    void loop();
+
+    void setTapHandler(CallbackFunction f) { _tapCb = f; }
+    void setClickHandler(CallbackFunction f) { _clickCb = f; }
+    void setLongClickHandler(CallbackFunction f) { _longClickCb = f; }
+    void setPressedHandler(CallbackFunction f) { _pressedCb = f; }
+    void setReleasedHandler(CallbackFunction f) { _releasedCb = f; }
+    void setLongClickTime(unsigned int ms) { _longClickTime = ms; }
+    void setDebounceTime(unsigned int ms) { _debounceTime = ms; }
+
+    bool isPressed() const { return _pressed; }
+    uint8_t getPin() const { return _pin; }
+    unsigned long wasPressedFor() const { return _downTime; }
+
+private:
+    uint8_t _pin = 255;
+    bool _activeLow = true;
+    bool _pressed = false;
+    unsigned long _downMs = 0;
+    unsigned long _downTime = 0;
+    unsigned long _lastChange = 0;
+    unsigned int _longClickTime = 200;
+    unsigned int _debounceTime = 50;
+    CallbackFunction _tapCb = NULL;
+    CallbackFunction _clickCb = NULL;
+    CallbackFunction _longClickCb = NULL;
+    CallbackFunction _pressedCb = NULL;
+    CallbackFunction _releasedCb = NULL;
+};
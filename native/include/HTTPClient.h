@@ -0,0 +1,68 @@
+// Native shim: HTTPClient over NativeTransport. The whole response is
+// buffered; the body is then read through the WiFiClient like a socket. As on
+// the device, a chunked body reports no size and the stream carries the chunk
+// framing (getString() and writeToStream() de-chunk).
+#pragma once
+#include <Arduino.h>
+#include "WiFiClient.h"
+
+#define HTTPC_ERROR_CONNECTION_REFUSED  (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED  (-2)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED       (-4)
+#define HTTPC_ERROR_CONNECTION_LOST     (-5)
+#define HTTPC_ERROR_NO_STREAM           (-6)
+#define HTTPC_ERROR_NO_HTTP_SERVER      (-7)
+#define HTTPC_ERROR_TOO_LESS_RAM        (-8)
+#define HTTPC_ERROR_ENCODING            (-9)
+#define HTTPC_ERROR_STREAM_WRITE        (-10)
+#define HTTPC_ERROR_READ_TIMEOUT        (-11)
+
+#define HTTP_CODE_OK 200
+#define HTTP_CODE_NO_CONTENT 204
+#define HTTP_CODE_UNAUTHORIZED 401
+
+class HTTPClient {
+public:
+    bool begin(WiFiClient& client, String url);
+    void end();
+
+    void setReuse(bool reuse) { _reuse = reuse; }
+    void useHTTP10(bool usehttp10) { _http10 = usehttp10; }
+    void setTimeout(uint16_t timeout) { (void)timeout; }
+    void setConnectTimeout(int32_t timeout) { (void)timeout; }
+
+    void addHeader(const String& name, const String& value);
+    void collectHeaders(const char* headerKeys[], const size_t headerKeysCount);
+    String header(const char* name);
+    bool hasHeader(const char* name);
+
+    int GET() { return sendRequest("GET"); }
+    int POST(const String& payload) { return sendRequest("POST", payload); }
+    int POST(uint8_t* payload, size_t size) { return sendRequest("POST", payload, size); }
+    int PUT(const String& payload) { return sendRequest("PUT", payload); }
+    int PUT(uint8_t* payload, size_t size) { return sendRequest("PUT", payload, size); }
+    int sendRequest(const char* type, const String& payload) {
+        return sendRequest(type, (uint8_t*)payload.c_str(), payload.length());
+    }
+    int sendRequest(const char* type, uint8_t* payload = NULL, size_t size = 0);
+
+    int getSize() { return _size; }
+    WiFiClient& getStream() { return *_client; }
+    WiFiClient* getStreamPtr() { return (_client && connected()) ? _client : NULL; }
+    String getString();
+    int writeToStream(Stream* stream);
+    bool connected() { return _client && _client->connected(); }
+    static String errorToString(int error);
+
+private:
+    WiFiClient* _client = NULL;
+    NativeHttpRequest _request;
+    NativeHeaders _responseHeaders;
+    std::vector<std::string> _collect;
+    int _size = -1;
+    bool _chunked = false;
+    bool _reuse = true;
+    bool _http10 = false;
+    bool _canReuse = false;
+};
@@ -0,0 +1,16 @@
+// Native shim: LittleFS backed by the host directory named in NATIVE_FS_DIR
+// (a fresh temporary directory when unset, so runs start empty)
+#pragma once
+#include <FS.h>
+
+class LittleFSFS : public fs::FS {
+public:
+    bool begin(bool formatOnFail = false, const char* basePath = "/littlefs",
+               uint8_t maxOpenFiles = 10, const char* partitionLabel = "spiffs");
+    void end() {}
+    bool format();
+    size_t totalBytes();
+    size_t usedBytes();
+};
+
+extern LittleFSFS LittleFS;
@@ -0,0 +1,53 @@
+// Native shim: pluggable HTTP transport behind WiFiClient/HTTPClient.
+//
+// HTTPClient hands every request to the installed NativeTransport. The default
+// SocketTransport speaks plain HTTP/1.1 (keep-alive) to NATIVE_HTTP_ORIGIN,
+// e.g. "127.0.0.1:8321", whatever host the firmware asked for. The original
+// host is kept in the Host header so a local mock can route by it. Benchmarks
+// can install their own transport (canned responses, recorded sessions).
+#pragma once
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+typedef std::vector<std::pair<std::string, std::string>> NativeHeaders;
+
+struct NativeHttpRequest {
+    std::string method;
+    std::string scheme; // "https" / "http"
+    std::string host;
+    uint16_t port = 443;
+    std::string path;   // Including query string
+    NativeHeaders headers;
+    std::string body;
+};
+
+struct NativeHttpResponse {
+    int status = 0;
+    NativeHeaders headers;
+    std::string body;   // A chunked body keeps its framing, as on the wire
+    bool chunked = false;
+    bool keepAlive = true;
+};
+
+// Connection state owned by a WiFiClient (one "TLS session")
+struct NativeSession {
+    int fd = -1;
+    bool open = false;
+    std::string host;
+    uint16_t port = 0;
+    std::string inbuf; // Received bytes not yet consumed by the transport
+};
+
+class NativeTransport {
+public:
+    virtual ~NativeTransport() {}
+    // Opens session if needed, performs one exchange. Returns false on
+    // connect/IO failure (session is closed in that case).
+    virtual bool perform(NativeSession& session, const NativeHttpRequest& req, NativeHttpResponse& resp) = 0;
+    virtual void close(NativeSession& session) = 0;
+};
+
+void nativeSetTransport(NativeTransport* transport);
+NativeTransport* nativeTransport();
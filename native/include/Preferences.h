@@ -0,0 +1,30 @@
+// Native shim: Preferences as an in-memory key/value map, optionally
+// persisted to the file named by NATIVE_PREFS_FILE
+#pragma once
+#include <Arduino.h>
+#include <map>
+#include <string>
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false, const char* partition = NULL);
+    void end() {}
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    size_t putString(const char* key, const char* value);
+    size_t putString(const char* key, const String& value) { return putString(key, value.c_str()); }
+    String getString(const char* key, const String& defaultValue = String());
+    size_t putBool(const char* key, bool value) { return putString(key, value ? "1" : "0"); }
+    bool getBool(const char* key, bool defaultValue = false);
+    size_t putInt(const char* key, int32_t value) { return putString(key, String((long)value)); }
+    int32_t getInt(const char* key, int32_t defaultValue = 0);
+    size_t putUInt(const char* key, uint32_t value) { return putString(key, String((unsigned long)value)); }
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0);
+
+private:
+    std::string _ns;
+    std::map<std::string, std::string>* _values = nullptr;
+    void save();
+};
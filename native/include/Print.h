@@ -0,0 +1,58 @@
+// Native shim: Arduino Print
+#pragma once
+#include <cstdarg>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include "WString.h"
+
+#define DEC 10
+#define HEX 16
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t n = 0;
+        while (size--) n += write(*buffer++);
+        return n;
+    }
+    virtual void flush() {}
+
+    size_t write(const char* s) { return s ? write((const uint8_t*)s, strlen(s)) : 0; }
+    size_t write(const char* s, size_t n) { return write((const uint8_t*)s, n); }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        char small[256];
+        va_list args;
+        va_start(args, format);
+        int len = vsnprintf(small, sizeof(small), format, args);
+        va_end(args);
+        if (len < 0) return 0;
+        if ((size_t)len < sizeof(small)) return write((const uint8_t*)small, len);
+        std::string big(len + 1, '\0');
+        va_start(args, format);
+        vsnprintf(&big[0], big.size(), format, args);
+        va_end(args);
+        return write((const uint8_t*)big.data(), len);
+    }
+
+    size_t print(const char* s) { return write(s); }
+    size_t print(const String& s) { return write(s.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int v, int base = DEC) { return printNumber((long)v, base); }
+    size_t print(unsigned int v, int base = DEC) { return printNumber((unsigned long)v, base); }
+    size_t print(long v, int base = DEC) { return printNumber(v, base); }
+    size_t print(unsigned long v, int base = DEC) { return printNumber(v, base); }
+    size_t print(double v, int digits = 2) { return printf("%.*f", digits, v); }
+
+    size_t println() { return write("\r\n"); }
+    template <typename T> size_t println(const T& v) { size_t n = print(v); return n + println(); }
+    template <typename T> size_t println(const T& v, int fmt) { size_t n = print(v, fmt); return n + println(); }
+
+private:
+    size_t printNumber(long v, int base) { return base == HEX ? printf("%lx", v) : printf("%ld", v); }
+    size_t printNumber(unsigned long v, int base) { return base == HEX ? printf("%lx", v) : printf("%lu", v); }
+};
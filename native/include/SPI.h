@@ -0,0 +1,2 @@
+// Native shim: SPI is handled inside the TFT_eSPI shim
+#pragma once
@@ -0,0 +1,49 @@
+// Native shim: Arduino Stream
+#pragma once
+#include "Print.h"
+
+unsigned long millis();
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+    unsigned long getTimeout() const { return _timeout; }
+
+    virtual size_t readBytes(char* buffer, size_t length) {
+        size_t count = 0;
+        while (count < length) {
+            int c = timedRead();
+            if (c < 0) break;
+            *buffer++ = (char)c;
+            count++;
+        }
+        return count;
+    }
+    size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+
+    String readStringUntil(char terminator) {
+        String ret;
+        int c = timedRead();
+        while (c >= 0 && c != terminator) {
+            ret += (char)c;
+            c = timedRead();
+        }
+        return ret;
+    }
+
+protected:
+    unsigned long _timeout = 1000;
+
+    int timedRead() {
+        unsigned long start = millis();
+        do {
+            int c = read();
+            if (c >= 0) return c;
+        } while (millis() - start < _timeout);
+        return -1;
+    }
+};
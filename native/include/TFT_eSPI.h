@@ -0,0 +1,135 @@
+// Native shim: TFT_eSPI drawing into an in-memory RGB565 framebuffer.
+// Geometry, clipping, viewports and text cursor/wrap behave like the real
+// library so layouts and pixel counts match the panel. GLCD glyphs are drawn
+// as their 5x7 cell footprint rather than real letter shapes. TFT_eSprite
+// reuses the same rasteriser on its own buffer, kept in wire (big endian)
+// order like the real 16-bit sprites.
+#pragma once
+#include <Arduino.h>
+#include <SPI.h>
+#include <vector>
+
+#define TFT_BLACK   0x0000
+#define TFT_NAVY    0x000F
+#define TFT_DARKGREY 0x7BEF
+#define TFT_BLUE    0x001F
+#define TFT_GREEN   0x07E0
+#define TFT_CYAN    0x07FF
+#define TFT_RED     0xF800
+#define TFT_MAGENTA 0xF81F
+#define TFT_YELLOW  0xFFE0
+#define TFT_WHITE   0xFFFF
+#define TFT_ORANGE  0xFDA0
+
+#ifndef TFT_WIDTH
+#define TFT_WIDTH  320
+#endif
+#ifndef TFT_HEIGHT
+#define TFT_HEIGHT 480
+#endif
+
+class TFT_eSPI : public Print {
+public:
+    TFT_eSPI(int16_t w = TFT_WIDTH, int16_t h = TFT_HEIGHT);
+
+    void init();
+    void begin() { init(); }
+    void setRotation(uint8_t r);
+    uint8_t getRotation() const { return _rotation; }
+    int16_t width() const { return _vpDatum ? _vpW - _vpX : _width; }
+    int16_t height() const { return _vpDatum ? _vpH - _vpY : _height; }
+
+    void startWrite() {}
+    void endWrite() {}
+
+    void fillScreen(uint32_t color) { fillRect(0, 0, _width, _height, color); }
+    void drawPixel(int32_t x, int32_t y, uint32_t color);
+    void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color) { fillRect(x, y, w, 1, color); }
+    void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color) { fillRect(x, y, 1, h, color); }
+    void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void fillTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color);
+    void fillCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color);
+
+    void setSwapBytes(bool swap) { _swapBytes = swap; }
+    bool getSwapBytes() const { return _swapBytes; }
+    void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* data);
+    void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data) {
+        pushImage(x, y, w, h, (uint16_t*)data);
+    }
+
+    // DMA: transfers complete immediately into the framebuffer
+    bool initDMA(bool ctrl_cs = false) { (void)ctrl_cs; _dma = true; return true; }
+    void deInitDMA() { _dma = false; }
+    bool dmaBusy() { return false; }
+    void dmaWait() {}
+    void setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h);
+    void pushPixels(const void* data, uint32_t len);
+    void pushPixelsDMA(uint16_t* image, uint32_t len) { if (_dma) pushPixels(image, len); }
+
+    void setViewport(int32_t x, int32_t y, int32_t w, int32_t h, bool vpDatum = true);
+    void resetViewport();
+
+    void setCursor(int16_t x, int16_t y) { _cursorX = x; _cursorY = y; }
+    int16_t getCursorX() const { return _cursorX; }
+    int16_t getCursorY() const { return _cursorY; }
+    void setTextColor(uint16_t fg) { _textColor = _textBgColor = fg; }
+    void setTextColor(uint16_t fg, uint16_t bg, bool bgfill = false) { (void)bgfill; _textColor = fg; _textBgColor = bg; }
+    void setTextSize(uint8_t s) { _textSize = s ? s : 1; }
+    void setTextWrap(bool wrapX, bool wrapY = false) { _wrapX = wrapX; _wrapY = wrapY; }
+
+    size_t write(uint8_t c) override;
+    using Print::write;
+
+    // --- Native-only ---
+    uint16_t readPixel(int32_t x, int32_t y) const;
+    uint64_t pixelsWritten() const { return _pixels; }
+    bool savePPM(const char* path) const;
+
+protected:
+    int16_t _initWidth, _initHeight;
+    int16_t _width, _height;
+    uint8_t _rotation = 0;
+    std::vector<uint16_t> _fb;
+    uint64_t _pixels = 0;
+    bool _swapBytes = false;
+    bool _dma = false;
+    int32_t _winX = 0, _winY = 0, _winW = 0, _winH = 0; // setAddrWindow target
+    uint32_t _winPos = 0;
+
+    int32_t _vpX = 0, _vpY = 0, _vpW, _vpH; // Clip box (absolute, exclusive max)
+    int32_t _xDatum = 0, _yDatum = 0;
+    bool _vpDatum = false;
+
+    int16_t _cursorX = 0, _cursorY = 0;
+    uint16_t _textColor = TFT_WHITE, _textBgColor = TFT_WHITE;
+    uint8_t _textSize = 1;
+    bool _wrapX = true, _wrapY = false;
+    bool _wireOrder = false; // Sprites store pixels byte swapped
+
+    uint16_t store(uint32_t color) const {
+        return _wireOrder ? (uint16_t)((color >> 8) | (color << 8)) : (uint16_t)color;
+    }
+    void drawChar(int32_t x, int32_t y, uint8_t c);
+};
+
+#define PSRAM_ENABLE 3
+
+class TFT_eSprite : public TFT_eSPI {
+public:
+    explicit TFT_eSprite(TFT_eSPI* tft) : TFT_eSPI(0, 0), _tft(tft) { _wireOrder = true; }
+
+    void* createSprite(int16_t w, int16_t h, uint8_t frames = 1);
+    void deleteSprite();
+    bool created() const { return !_fb.empty(); }
+    void setColorDepth(int8_t bpp) { (void)bpp; } // 16-bit only
+    void setAttribute(uint8_t id, uint8_t value) { (void)id; (void)value; }
+    void* getPointer() { return _fb.empty() ? nullptr : _fb.data(); }
+    void fillSprite(uint32_t color) { fillRect(0, 0, _width, _height, color); }
+    void pushSprite(int32_t x, int32_t y);
+
+private:
+    TFT_eSPI* _tft;
+};
+
+extern TFT_eSPI* nativeDisplay; // Last initialised panel, for "!dump"
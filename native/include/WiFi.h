@@ -0,0 +1,22 @@
+// Native shim: WiFi status only (toggle with "!wifi 0|1" on stdin)
+#pragma once
+#include <Arduino.h>
+#include "WiFiClient.h"
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+class WiFiClass {
+public:
+    wl_status_t status();
+    bool setSleep(bool) { return true; }
+    int8_t RSSI() { return -50; }
+    void setConnected(bool connected);
+};
+extern WiFiClass WiFi;
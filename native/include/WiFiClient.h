@@ -0,0 +1,35 @@
+// Native shim: WiFiClient reading from a buffered HTTP response body
+#pragma once
+#include <Arduino.h>
+#include "NativeTransport.h"
+
+class WiFiClient : public Stream {
+public:
+    WiFiClient() {}
+    virtual ~WiFiClient() { stop(); }
+    WiFiClient(const WiFiClient&) = delete;
+    WiFiClient& operator=(const WiFiClient&) = delete;
+
+    uint8_t connected() { return session.open || available() > 0; }
+    void stop();
+
+    int available() override { return (int)(rx.size() - rxPos); }
+    int read() override { return rxPos < rx.size() ? (uint8_t)rx[rxPos++] : -1; }
+    int peek() override { return rxPos < rx.size() ? (uint8_t)rx[rxPos] : -1; }
+    size_t readBytes(char* buffer, size_t length) override {
+        size_t n = rx.size() - rxPos;
+        if (n > length) n = length;
+        memcpy(buffer, rx.data() + rxPos, n);
+        rxPos += n;
+        return n;
+    }
+    using Stream::readBytes;
+    size_t write(uint8_t) override { return 0; }
+
+    // --- Native ---
+    NativeSession session;
+    std::string rx;
+    size_t rxPos = 0;
+
+    void setRx(std::string body) { rx = std::move(body); rxPos = 0; }
+};
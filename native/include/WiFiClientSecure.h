@@ -0,0 +1,10 @@
+// Native shim: TLS is not simulated; the transport decides what a session costs
+#pragma once
+#include "WiFiClient.h"
+
+class WiFiClientSecure : public WiFiClient {
+public:
+    void setInsecure() {}
+    void setCACert(const char*) {}
+    void setHandshakeTimeout(unsigned long) {}
+};
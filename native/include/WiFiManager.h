@@ -0,0 +1,16 @@
+// Native shim: the workstation is always "on WiFi"
+#pragma once
+#include <Arduino.h>
+#include <WiFi.h>
+
+class WiFiManager {
+public:
+    void setAPCallback(void (*func)(WiFiManager*)) { _apCallback = func; }
+    bool autoConnect(const char* apName) { _ssid = apName; return true; }
+    void resetSettings() {}
+    String getConfigPortalSSID() { return _ssid; }
+
+private:
+    void (*_apCallback)(WiFiManager*) = NULL;
+    String _ssid;
+};
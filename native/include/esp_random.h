@@ -0,0 +1,7 @@
+// Native shim: ESP-IDF hardware RNG
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+uint32_t esp_random();
+void esp_fill_random(void* buf, size_t len);
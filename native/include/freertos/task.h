@@ -0,0 +1,23 @@
+// Native shim: FreeRTOS tasks as detached std::threads
+#pragma once
+#include "FreeRTOS.h"
+
+struct NativeTask;
+typedef NativeTask* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackDepth,
+                                   void* param, UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t coreId);
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount();
+// No stack to scan natively: reports the whole requested depth as unused
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+
+// Task notifications (one 32-bit value per task, as in FreeRTOS)
+enum eNotifyAction { eNoAction, eSetBits, eIncrement, eSetValueWithOverwrite, eSetValueWithoutOverwrite };
+TaskHandle_t xTaskGetCurrentTaskHandle();
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action);
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action, BaseType_t* higherPriorityTaskWoken);
+BaseType_t xTaskNotifyWait(uint32_t clearOnEntry, uint32_t clearOnExit, uint32_t* value, TickType_t ticks);
+#define portYIELD_FROM_ISR(...) do {} while (0)
@@ -0,0 +1,178 @@
+// Native shim: Arduino core (time, GPIO, Serial, ESP) plus the stdin control channel
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include <WiFi.h>
+#include <esp_random.h>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unistd.h>
+
+static const auto bootTime = std::chrono::steady_clock::now();
+
+unsigned long millis() {
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - bootTime).count();
+}
+
+unsigned long micros() {
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - bootTime).count();
+}
+
+void delay(unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+void delayMicroseconds(unsigned int us) { std::this_thread::sleep_for(std::chrono::microseconds(us)); }
+void yield() { std::this_thread::yield(); }
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    if (in_max == in_min) return out_min; // Arduino would divide by zero here
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+bool setCpuFrequencyMhz(uint32_t) { return true; }
+
+bool psramFound() { return true; }
+void* ps_malloc(size_t size) { return malloc(size); }
+
+#ifndef NATIVE_HAS_STRLCPY
+size_t strlcpy(char* dst, const char* src, size_t size) {
+    size_t len = strlen(src);
+    if (size) {
+        size_t n = len < size - 1 ? len : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return len;
+}
+
+size_t strlcat(char* dst, const char* src, size_t size) {
+    size_t dlen = strnlen(dst, size);
+    if (dlen == size) return size + strlen(src);
+    return dlen + strlcpy(dst + dlen, src, size - dlen);
+}
+#endif
+
+// --- GPIO ---
+static volatile uint8_t pinLevel[64];
+static bool pinsInitialised = false;
+
+static void initPins() {
+    if (pinsInitialised) return;
+    for (auto& p : pinLevel) p = HIGH; // Pull-ups: buttons idle high
+    pinsInitialised = true;
+}
+
+static void (*pinIsr[64])() = {};
+static int pinIsrMode[64];
+
+void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; initPins(); }
+void digitalWrite(uint8_t pin, uint8_t val) { initPins(); if (pin < 64) pinLevel[pin] = val; }
+int digitalRead(uint8_t pin) { initPins(); return pin < 64 ? pinLevel[pin] : LOW; }
+
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode) {
+    if (pin < 64) { pinIsr[pin] = isr; pinIsrMode[pin] = mode; }
+}
+void detachInterrupt(uint8_t pin) { if (pin < 64) pinIsr[pin] = nullptr; }
+
+void nativeSetPin(uint8_t pin, int level) {
+    int before = digitalRead(pin);
+    digitalWrite(pin, level ? HIGH : LOW);
+    if (pin >= 64 || !pinIsr[pin] || before == digitalRead(pin)) return;
+    int edge = level ? RISING : FALLING;
+    if (pinIsrMode[pin] & edge) pinIsr[pin]();
+}
+
+// --- Serial ---
+HardwareSerial Serial;
+static std::mutex serialInMutex;
+static std::deque<uint8_t> serialIn;
+static std::function<void(void)> serialOnReceive;
+
+size_t HardwareSerial::write(uint8_t c) { return fwrite(&c, 1, 1, stdout); }
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    size_t n = fwrite(buffer, 1, size, stdout);
+    fflush(stdout);
+    return n;
+}
+int HardwareSerial::available() { std::lock_guard<std::mutex> l(serialInMutex); return (int)serialIn.size(); }
+int HardwareSerial::read() {
+    std::lock_guard<std::mutex> l(serialInMutex);
+    if (serialIn.empty()) return -1;
+    uint8_t c = serialIn.front();
+    serialIn.pop_front();
+    return c;
+}
+int HardwareSerial::peek() {
+    std::lock_guard<std::mutex> l(serialInMutex);
+    return serialIn.empty() ? -1 : serialIn.front();
+}
+void HardwareSerial::onReceive(std::function<void(void)> fn, bool onlyOnTimeout) {
+    (void)onlyOnTimeout;
+    serialOnReceive = fn;
+}
+
+// --- ESP ---
+EspClass ESP;
+
+void EspClass::restart() {
+    printf("\n[native] ESP.restart() - exiting\n");
+    fflush(stdout);
+    _exit(3);
+}
+
+uint32_t EspClass::getFreeHeap() { return 320 * 1024; }
+uint32_t EspClass::getMinFreeHeap() { return 280 * 1024; }
+uint32_t EspClass::getPsramSize() { return 4 << 20; }
+uint32_t EspClass::getFreePsram() { return 3 << 20; }
+uint32_t EspClass::getMinFreePsram() { return 3 << 20; }
+
+uint32_t esp_random() {
+    static std::mt19937 rng(std::random_device{}());
+    return rng();
+}
+
+void esp_fill_random(void* buf, size_t len) {
+    uint8_t* p = (uint8_t*)buf;
+    for (size_t i = 0; i < len; i++) p[i] = (uint8_t)esp_random();
+}
+
+// --- stdin control channel ---
+static void handleControl(const std::string& line) {
+    char arg[256] = "";
+    int a = 0, b = 0;
+    if (sscanf(line.c_str(), "!pin %d %d", &a, &b) == 2) {
+        nativeSetPin((uint8_t)a, b);
+    } else if (sscanf(line.c_str(), "!wifi %d", &a) == 1) {
+        WiFi.setConnected(a != 0);
+    } else if (sscanf(line.c_str(), "!dump %255s", arg) == 1) {
+        if (nativeDisplay) nativeDisplay->savePPM(arg);
+    } else if (line.rfind("!quit", 0) == 0) {
+        fflush(stdout);
+        _exit(0);
+    } else {
+        fprintf(stderr, "[native] unknown control: %s\n", line.c_str());
+    }
+}
+
+void nativeStartStdinReader() {
+    std::thread([] {
+        std::string line;
+        int c;
+        while ((c = getchar()) != EOF) {
+            if (c != '\n') { line += (char)c; continue; }
+            if (!line.empty() && line[0] == '!') {
+                handleControl(line);
+            } else {
+                {
+                    std::lock_guard<std::mutex> l(serialInMutex);
+                    for (char ch : line) serialIn.push_back((uint8_t)ch);
+                    serialIn.push_back('\n');
+                }
+                if (serialOnReceive) serialOnReceive();
+            }
+            line.clear();
+        }
+    }).detach();
+}
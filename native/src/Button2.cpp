@@ -0,0 +1,31 @@
+// Native shim: Button2 state machine (debounce, tap on every release)
+#include <Button2.h>
+
+void Button2::begin(uint8_t pin, uint8_t mode, bool activeLow) {
+    _pin = pin;
+    _activeLow = activeLow;
+    pinMode(pin, mode);
+}
+
+void Button2::loop() {
+    if (_pin == 255) return;
+    unsigned long now = millis();
+    bool down = (digitalRead(_pin) == LOW) == _activeLow;
+    if (down == _pressed || now - _lastChange < _debounceTime) return;
+    _lastChange = now;
+    _pressed = down;
+
+    if (down) {
+        _downMs = now;
+        if (_pressedCb) _pressedCb(*this);
+        return;
+    }
+    _downTime = now - _downMs;
+    if (_releasedCb) _releasedCb(*this);
+    if (_tapCb) _tapCb(*this);
+    if (_downTime >= _longClickTime) {
+        if (_longClickCb) _longClickCb(*this);
+    } else if (_clickCb) {
+        _clickCb(*this);
+    }
+}
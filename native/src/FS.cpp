@@ -0,0 +1,216 @@
+// Native shim: fs::FS / LittleFS on a host directory
+#include <LittleFS.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifndef NATIVE_FS_SIZE
+#define NATIVE_FS_SIZE (1472 * 1024) // Default "spiffs" partition of the ESP32 4MB layout
+#endif
+
+namespace fs {
+
+struct FileImpl {
+    std::string path;             // Path as the firmware sees it ("/art/abc")
+    std::string name;             // Last path segment
+    std::string host;             // Path on the host
+    FILE* fp = nullptr;
+    bool dir = false;
+    std::vector<std::string> entries;
+    size_t next = 0;
+    ~FileImpl() { if (fp) fclose(fp); }
+};
+
+static std::string baseName(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+size_t File::write(const uint8_t* buf, size_t size) {
+    if (!_impl || !_impl->fp) return 0;
+    return fwrite(buf, 1, size, _impl->fp);
+}
+
+int File::available() {
+    if (!_impl || !_impl->fp) return 0;
+    long pos = ftell(_impl->fp);
+    return (int)(size() - (pos < 0 ? 0 : pos));
+}
+
+int File::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::peek() {
+    if (!_impl || !_impl->fp) return -1;
+    int c = fgetc(_impl->fp);
+    if (c != EOF) ungetc(c, _impl->fp);
+    return c == EOF ? -1 : c;
+}
+
+size_t File::read(uint8_t* buf, size_t size) {
+    if (!_impl || !_impl->fp) return 0;
+    return fread(buf, 1, size, _impl->fp);
+}
+
+void File::flush() {
+    if (_impl && _impl->fp) fflush(_impl->fp);
+}
+
+bool File::seek(uint32_t pos) {
+    return _impl && _impl->fp && fseek(_impl->fp, pos, SEEK_SET) == 0;
+}
+
+size_t File::position() const {
+    if (!_impl || !_impl->fp) return 0;
+    long pos = ftell(_impl->fp);
+    return pos < 0 ? 0 : (size_t)pos;
+}
+
+size_t File::size() const {
+    if (!_impl || _impl->dir) return 0;
+    if (_impl->fp) fflush(_impl->fp);
+    struct stat st;
+    return stat(_impl->host.c_str(), &st) == 0 ? (size_t)st.st_size : 0;
+}
+
+void File::close() {
+    _impl.reset();
+}
+
+File::operator bool() const {
+    return _impl && (_impl->dir || _impl->fp);
+}
+
+const char* File::path() const { return _impl ? _impl->path.c_str() : ""; }
+const char* File::name() const { return _impl ? _impl->name.c_str() : ""; }
+bool File::isDirectory() const { return _impl && _impl->dir; }
+
+File File::openNextFile(const char* mode) {
+    if (!_impl || !_impl->dir || _impl->next >= _impl->entries.size()) return File();
+    std::string child = _impl->path;
+    if (child.empty() || child.back() != '/') child += '/';
+    child += _impl->entries[_impl->next++];
+    return LittleFS.open(child.c_str(), mode);
+}
+
+void File::rewindDirectory() {
+    if (_impl) _impl->next = 0;
+}
+
+std::string FS::hostPath(const char* path) const {
+    std::string p = path ? path : "";
+    if (p.empty() || p[0] != '/') p = "/" + p;
+    return _root + p;
+}
+
+File FS::open(const char* path, const char* mode, bool create) {
+    (void)create;
+    if (_root.empty()) return File();
+    auto impl = std::make_shared<FileImpl>();
+    impl->path = path;
+    impl->name = baseName(path);
+    impl->host = hostPath(path);
+
+    struct stat st;
+    bool exists = stat(impl->host.c_str(), &st) == 0;
+    if (exists && S_ISDIR(st.st_mode)) {
+        impl->dir = true;
+        if (DIR* d = opendir(impl->host.c_str())) {
+            while (struct dirent* e = readdir(d)) {
+                if (strcmp(e->d_name, ".") && strcmp(e->d_name, "..")) impl->entries.push_back(e->d_name);
+            }
+            closedir(d);
+        }
+        std::sort(impl->entries.begin(), impl->entries.end());
+        return File(impl);
+    }
+    const char* m = "rb";
+    if (mode[0] == 'w') m = mode[1] == '+' ? "w+b" : "wb";
+    else if (mode[0] == 'a') m = mode[1] == '+' ? "a+b" : "ab";
+    else if (mode[1] == '+') m = "r+b";
+    if (!exists && mode[0] == 'r') return File();
+    impl->fp = fopen(impl->host.c_str(), m);
+    return impl->fp ? File(impl) : File();
+}
+
+bool FS::exists(const char* path) {
+    struct stat st;
+    return !_root.empty() && stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool FS::remove(const char* path) {
+    return !_root.empty() && unlink(hostPath(path).c_str()) == 0;
+}
+
+bool FS::rename(const char* pathFrom, const char* pathTo) {
+    return !_root.empty() && ::rename(hostPath(pathFrom).c_str(), hostPath(pathTo).c_str()) == 0;
+}
+
+bool FS::mkdir(const char* path) {
+    return !_root.empty() && (::mkdir(hostPath(path).c_str(), 0755) == 0 || errno == EEXIST);
+}
+
+bool FS::rmdir(const char* path) {
+    return !_root.empty() && ::rmdir(hostPath(path).c_str()) == 0;
+}
+
+} // namespace fs
+
+LittleFSFS LittleFS;
+
+bool LittleFSFS::begin(bool formatOnFail, const char* basePath, uint8_t maxOpenFiles, const char* partitionLabel) {
+    (void)formatOnFail; (void)basePath; (void)maxOpenFiles; (void)partitionLabel;
+    if (!_root.empty()) return true;
+    if (const char* dir = getenv("NATIVE_FS_DIR")) {
+        ::mkdir(dir, 0755);
+        _root = dir;
+    } else {
+        char tmpl[] = "/tmp/native_fs_XXXXXX";
+        if (!mkdtemp(tmpl)) return false;
+        _root = tmpl;
+    }
+    return true;
+}
+
+static size_t duBytes(const std::string& dir) {
+    size_t total = 0;
+    DIR* d = opendir(dir.c_str());
+    if (!d) return 0;
+    while (struct dirent* e = readdir(d)) {
+        if (!strcmp(e->d_name, ".") || !strcmp(e->d_name, "..")) continue;
+        std::string p = dir + "/" + e->d_name;
+        struct stat st;
+        if (stat(p.c_str(), &st) != 0) continue;
+        total += S_ISDIR(st.st_mode) ? duBytes(p) : (size_t)st.st_size;
+    }
+    closedir(d);
+    return total;
+}
+
+static void wipe(const std::string& dir) {
+    DIR* d = opendir(dir.c_str());
+    if (!d) return;
+    while (struct dirent* e = readdir(d)) {
+        if (!strcmp(e->d_name, ".") || !strcmp(e->d_name, "..")) continue;
+        std::string p = dir + "/" + e->d_name;
+        struct stat st;
+        if (stat(p.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) { wipe(p); ::rmdir(p.c_str()); }
+        else unlink(p.c_str());
+    }
+    closedir(d);
+}
+
+bool LittleFSFS::format() {
+    if (_root.empty()) return false;
+    wipe(_root);
+    return true;
+}
+
+size_t LittleFSFS::totalBytes() { return NATIVE_FS_SIZE; }
+size_t LittleFSFS::usedBytes() { return _root.empty() ? 0 : duBytes(_root); }
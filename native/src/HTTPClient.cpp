@@ -0,0 +1,292 @@
+// Native shim: HTTPClient, WiFi and the default socket transport
+#include <HTTPClient.h>
+#include <WiFi.h>
+#include <WiFiClientSecure.h>
+#include <atomic>
+#include <cerrno>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// --- WiFi ---
+WiFiClass WiFi;
+static std::atomic<bool> wifiUp(true);
+
+wl_status_t WiFiClass::status() { return wifiUp ? WL_CONNECTED : WL_DISCONNECTED; }
+void WiFiClass::setConnected(bool connected) { wifiUp = connected; }
+
+// --- Socket transport (plain HTTP/1.1 to NATIVE_HTTP_ORIGIN) ---
+class SocketTransport : public NativeTransport {
+public:
+    bool perform(NativeSession& s, const NativeHttpRequest& req, NativeHttpResponse& resp) override {
+        if (!s.open && !connectOrigin(s)) return false;
+
+        std::string out = req.method + " " + req.path + " HTTP/1.1\r\n";
+        out += "Host: " + req.host + "\r\n";
+        for (auto& h : req.headers) out += h.first + ": " + h.second + "\r\n";
+        if (!req.body.empty()) out += "Content-Length: " + std::to_string(req.body.size()) + "\r\n";
+        out += "\r\n" + req.body;
+        if (!sendAll(s.fd, out) || !readResponse(s, req, resp)) {
+            close(s);
+            return false;
+        }
+        if (!resp.keepAlive) close(s);
+        return true;
+    }
+
+    void close(NativeSession& s) override {
+        if (s.fd >= 0) ::close(s.fd);
+        s.fd = -1;
+        s.open = false;
+    }
+
+private:
+    bool connectOrigin(NativeSession& s) {
+        const char* origin = getenv("NATIVE_HTTP_ORIGIN");
+        if (!origin || !*origin) return false;
+        std::string o = origin;
+        size_t p = o.find("://");
+        if (p != std::string::npos) o = o.substr(p + 3);
+        while (!o.empty() && o.back() == '/') o.pop_back();
+        std::string host = o, port = "80";
+        p = o.rfind(':');
+        if (p != std::string::npos) { host = o.substr(0, p); port = o.substr(p + 1); }
+
+        addrinfo hints = {}, *res = nullptr;
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        if (getaddrinfo(host.c_str(), port.c_str(), &hints, &res) != 0) return false;
+        int fd = -1;
+        for (addrinfo* ai = res; ai; ai = ai->ai_next) {
+            fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd < 0) continue;
+            if (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) break;
+            ::close(fd);
+            fd = -1;
+        }
+        freeaddrinfo(res);
+        if (fd < 0) return false;
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        timeval tv = { 10, 0 };
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        s.fd = fd;
+        s.open = true;
+        s.inbuf.clear();
+        return true;
+    }
+
+    static bool sendAll(int fd, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) return false;
+            sent += n;
+        }
+        return true;
+    }
+
+    static bool fill(NativeSession& s) {
+        char tmp[4096];
+        ssize_t n = ::recv(s.fd, tmp, sizeof(tmp), 0);
+        if (n <= 0) return false;
+        s.inbuf.append(tmp, n);
+        return true;
+    }
+
+    static bool readLine(NativeSession& s, std::string& line) {
+        size_t p;
+        while ((p = s.inbuf.find("\r\n")) == std::string::npos) {
+            if (!fill(s)) return false;
+        }
+        line = s.inbuf.substr(0, p);
+        s.inbuf.erase(0, p + 2);
+        return true;
+    }
+
+    static bool readExact(NativeSession& s, size_t n, std::string& out) {
+        while (s.inbuf.size() < n) {
+            if (!fill(s)) return false;
+        }
+        out.append(s.inbuf, 0, n);
+        s.inbuf.erase(0, n);
+        return true;
+    }
+
+    bool readResponse(NativeSession& s, const NativeHttpRequest& req, NativeHttpResponse& resp) {
+        std::string line;
+        if (!readLine(s, line) || line.compare(0, 5, "HTTP/") != 0) return false;
+        resp.status = atoi(line.c_str() + line.find(' ') + 1);
+        resp.keepAlive = line.compare(0, 8, "HTTP/1.0") != 0;
+
+        long length = -1;
+        bool chunked = false;
+        while (readLine(s, line) && !line.empty()) {
+            size_t c = line.find(':');
+            if (c == std::string::npos) continue;
+            std::string name = line.substr(0, c), value = line.substr(c + 1);
+            while (!value.empty() && value[0] == ' ') value.erase(0, 1);
+            resp.headers.push_back({ name, value });
+            String n(name.c_str());
+            if (n.equalsIgnoreCase("Content-Length")) length = atol(value.c_str());
+            else if (n.equalsIgnoreCase("Transfer-Encoding")) chunked = value.find("chunked") != std::string::npos;
+            else if (n.equalsIgnoreCase("Connection")) resp.keepAlive = value.find("close") == std::string::npos;
+        }
+
+        if (req.method == "HEAD" || resp.status == 204 || resp.status == 304) return true;
+        if (chunked) {
+            resp.chunked = true;
+            for (;;) {
+                if (!readLine(s, line)) return false;
+                resp.body += line + "\r\n";
+                size_t size = strtoul(line.c_str(), nullptr, 16);
+                if (size == 0) {
+                    while (readLine(s, line)) {
+                        resp.body += line + "\r\n";
+                        if (line.empty()) return true;
+                    }
+                    return false;
+                }
+                if (!readExact(s, size + 2, resp.body)) return false;
+            }
+        }
+        if (length >= 0) return readExact(s, (size_t)length, resp.body);
+
+        // Close-delimited body
+        resp.keepAlive = false;
+        while (fill(s)) {}
+        resp.body += s.inbuf;
+        s.inbuf.clear();
+        return true;
+    }
+};
+
+static SocketTransport socketTransport;
+static NativeTransport* activeTransport = &socketTransport;
+
+void nativeSetTransport(NativeTransport* transport) { activeTransport = transport ? transport : &socketTransport; }
+NativeTransport* nativeTransport() { return activeTransport; }
+
+// --- WiFiClient ---
+void WiFiClient::stop() {
+    if (session.open) nativeTransport()->close(session);
+    rx.clear();
+    rxPos = 0;
+}
+
+// --- HTTPClient ---
+bool HTTPClient::begin(WiFiClient& client, String url) {
+    _client = &client;
+    _request = NativeHttpRequest();
+    _responseHeaders.clear();
+    _size = -1;
+    _chunked = false;
+
+    std::string u = url.std();
+    size_t p = u.find("://");
+    if (p == std::string::npos) return false;
+    _request.scheme = u.substr(0, p);
+    u = u.substr(p + 3);
+    p = u.find('/');
+    std::string hostPort = p == std::string::npos ? u : u.substr(0, p);
+    _request.path = p == std::string::npos ? "/" : u.substr(p);
+    _request.port = _request.scheme == "https" ? 443 : 80;
+    p = hostPort.find(':');
+    if (p != std::string::npos) {
+        _request.port = (uint16_t)atoi(hostPort.c_str() + p + 1);
+        hostPort = hostPort.substr(0, p);
+    }
+    _request.host = hostPort;
+    return true;
+}
+
+void HTTPClient::end() {
+    if (!_client) return;
+    _client->rx.clear();
+    _client->rxPos = 0;
+    if (!_reuse || !_canReuse || _http10) _client->stop();
+}
+
+void HTTPClient::addHeader(const String& name, const String& value) {
+    _request.headers.push_back({ name.std(), value.std() });
+}
+
+void HTTPClient::collectHeaders(const char* headerKeys[], const size_t headerKeysCount) {
+    _collect.assign(headerKeys, headerKeys + headerKeysCount);
+}
+
+String HTTPClient::header(const char* name) {
+    for (auto& key : _collect) {
+        if (!String(key.c_str()).equalsIgnoreCase(name)) continue;
+        for (auto& h : _responseHeaders) {
+            if (String(h.first.c_str()).equalsIgnoreCase(name)) return String(h.second.c_str());
+        }
+    }
+    return String();
+}
+
+bool HTTPClient::hasHeader(const char* name) { return header(name).length() > 0; }
+
+int HTTPClient::sendRequest(const char* type, uint8_t* payload, size_t size) {
+    if (!_client) return HTTPC_ERROR_NOT_CONNECTED;
+    bool reused = _client->session.open;
+    _request.method = type;
+    _request.body.assign((const char*)(payload ? payload : (uint8_t*)""), payload ? size : 0);
+    bool closeAfter = !_reuse || _http10;
+    if (closeAfter) _request.headers.push_back({ "Connection", "close" });
+
+    NativeHttpResponse resp;
+    if (!nativeTransport()->perform(_client->session, _request, resp)) {
+        _client->stop();
+        return reused ? HTTPC_ERROR_CONNECTION_LOST : HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    if (closeAfter) _request.headers.pop_back();
+
+    _canReuse = resp.keepAlive;
+    _responseHeaders = resp.headers;
+    _chunked = resp.chunked;
+    _size = _chunked ? -1 : (int)resp.body.size();
+    _client->setRx(std::move(resp.body));
+    return resp.status;
+}
+
+// The unread body without its chunk framing
+static std::string takeBody(WiFiClient& client, bool chunked) {
+    std::string raw = client.rx.substr(client.rxPos), body;
+    client.rxPos = client.rx.size();
+    if (!chunked) return raw;
+    size_t pos = 0;
+    for (;;) {
+        size_t eol = raw.find("\r\n", pos);
+        if (eol == std::string::npos) break;
+        size_t size = strtoul(raw.c_str() + pos, nullptr, 16);
+        if (size == 0) break;
+        body.append(raw, eol + 2, size);
+        pos = eol + 2 + size + 2;
+    }
+    return body;
+}
+
+String HTTPClient::getString() {
+    if (!_client) return String();
+    return String(takeBody(*_client, _chunked));
+}
+
+int HTTPClient::writeToStream(Stream* stream) {
+    if (!_client) return HTTPC_ERROR_NO_STREAM;
+    std::string body = takeBody(*_client, _chunked);
+    stream->write((const uint8_t*)body.data(), body.size());
+    return (int)body.size();
+}
+
+String HTTPClient::errorToString(int error) {
+    switch (error) {
+    case HTTPC_ERROR_CONNECTION_REFUSED: return String("connection refused");
+    case HTTPC_ERROR_CONNECTION_LOST: return String("connection lost");
+    case HTTPC_ERROR_NOT_CONNECTED: return String("not connected");
+    case HTTPC_ERROR_READ_TIMEOUT: return String("read Timeout");
+    default: return String();
+    }
+}
@@ -0,0 +1,87 @@
+// Native shim: Preferences (namespace -> key -> value as text)
+#include <Preferences.h>
+#include <fstream>
+#include <mutex>
+
+static std::mutex prefsMutex;
+static std::map<std::string, std::map<std::string, std::string>> store;
+static bool loaded = false;
+
+static void loadStore() {
+    if (loaded) return;
+    loaded = true;
+    const char* path = getenv("NATIVE_PREFS_FILE");
+    if (!path) return;
+    std::ifstream in(path);
+    std::string ns, key, value;
+    while (std::getline(in, ns, '\t') && std::getline(in, key, '\t') && std::getline(in, value)) {
+        store[ns][key] = value;
+    }
+}
+
+void Preferences::save() {
+    const char* path = getenv("NATIVE_PREFS_FILE");
+    if (!path) return;
+    std::ofstream out(path, std::ios::trunc);
+    for (auto& ns : store) {
+        for (auto& kv : ns.second) out << ns.first << '\t' << kv.first << '\t' << kv.second << '\n';
+    }
+}
+
+bool Preferences::begin(const char* name, bool readOnly, const char* partition) {
+    (void)readOnly; (void)partition;
+    std::lock_guard<std::mutex> l(prefsMutex);
+    loadStore();
+    _ns = name;
+    _values = &store[_ns];
+    return true;
+}
+
+bool Preferences::clear() {
+    std::lock_guard<std::mutex> l(prefsMutex);
+    if (!_values) return false;
+    _values->clear();
+    save();
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    std::lock_guard<std::mutex> l(prefsMutex);
+    if (!_values || !_values->erase(key)) return false;
+    save();
+    return true;
+}
+
+bool Preferences::isKey(const char* key) {
+    std::lock_guard<std::mutex> l(prefsMutex);
+    return _values && _values->count(key);
+}
+
+size_t Preferences::putString(const char* key, const char* value) {
+    std::lock_guard<std::mutex> l(prefsMutex);
+    if (!_values) return 0;
+    (*_values)[key] = value;
+    save();
+    return strlen(value);
+}
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+    std::lock_guard<std::mutex> l(prefsMutex);
+    if (!_values || !_values->count(key)) return defaultValue;
+    return String((*_values)[key].c_str());
+}
+
+bool Preferences::getBool(const char* key, bool defaultValue) {
+    String v = getString(key);
+    return v.length() ? v.toInt() != 0 : defaultValue;
+}
+
+int32_t Preferences::getInt(const char* key, int32_t defaultValue) {
+    String v = getString(key);
+    return v.length() ? (int32_t)v.toInt() : defaultValue;
+}
+
+uint32_t Preferences::getUInt(const char* key, uint32_t defaultValue) {
+    String v = getString(key);
+    return v.length() ? (uint32_t)strtoul(v.c_str(), nullptr, 10) : defaultValue;
+}
@@ -0,0 +1,194 @@
+// Native shim: TFT_eSPI framebuffer implementation
+#include <TFT_eSPI.h>
+#include <algorithm>
+
+TFT_eSPI* nativeDisplay = NULL;
+
+TFT_eSPI::TFT_eSPI(int16_t w, int16_t h)
+    : _initWidth(w), _initHeight(h), _width(w), _height(h), _vpW(w), _vpH(h) {}
+
+void TFT_eSPI::init() {
+    _fb.assign((size_t)_initWidth * _initHeight, TFT_BLACK);
+    nativeDisplay = this;
+    setRotation(_rotation);
+}
+
+void TFT_eSPI::setRotation(uint8_t r) {
+    _rotation = r & 3;
+    bool landscape = _rotation & 1;
+    _width = landscape ? _initHeight : _initWidth;
+    _height = landscape ? _initWidth : _initHeight;
+    resetViewport();
+}
+
+void TFT_eSPI::setViewport(int32_t x, int32_t y, int32_t w, int32_t h, bool vpDatum) {
+    _vpDatum = vpDatum;
+    _xDatum = vpDatum ? x : 0;
+    _yDatum = vpDatum ? y : 0;
+    _vpX = std::max<int32_t>(x, 0);
+    _vpY = std::max<int32_t>(y, 0);
+    _vpW = std::min<int32_t>(x + w, _width);
+    _vpH = std::min<int32_t>(y + h, _height);
+}
+
+void TFT_eSPI::resetViewport() {
+    _vpDatum = false;
+    _xDatum = _yDatum = 0;
+    _vpX = _vpY = 0;
+    _vpW = _width;
+    _vpH = _height;
+}
+
+void TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color) { fillRect(x, y, 1, 1, color); }
+
+void TFT_eSPI::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    x += _xDatum;
+    y += _yDatum;
+    int32_t x0 = std::max(x, _vpX), y0 = std::max(y, _vpY);
+    int32_t x1 = std::min(x + w, _vpW), y1 = std::min(y + h, _vpH);
+    if (x0 >= x1 || y0 >= y1 || _fb.empty()) return;
+    for (int32_t yy = y0; yy < y1; yy++) {
+        std::fill(&_fb[(size_t)yy * _width + x0], &_fb[(size_t)yy * _width + x1], store(color));
+    }
+    _pixels += (uint64_t)(x1 - x0) * (y1 - y0);
+}
+
+void TFT_eSPI::drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    fillRect(x, y, w, 1, color);
+    fillRect(x, y + h - 1, w, 1, color);
+    fillRect(x, y + 1, 1, h - 2, color);
+    fillRect(x + w - 1, y + 1, 1, h - 2, color);
+}
+
+void TFT_eSPI::fillTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color) {
+    int32_t minY = std::min({ y0, y1, y2 }), maxY = std::max({ y0, y1, y2 });
+    for (int32_t y = minY; y <= maxY; y++) {
+        // Scanline: intersect the three edges with this row
+        int32_t xs[3], n = 0;
+        int32_t px[3] = { x0, x1, x2 }, py[3] = { y0, y1, y2 };
+        for (int i = 0; i < 3; i++) {
+            int32_t ax = px[i], ay = py[i], bx = px[(i + 1) % 3], by = py[(i + 1) % 3];
+            if (ay == by) continue;
+            if ((y < std::min(ay, by)) || (y > std::max(ay, by))) continue;
+            xs[n++] = ax + (y - ay) * (bx - ax) / (by - ay);
+        }
+        if (n < 2) continue;
+        int32_t a = std::min(xs[0], xs[1]), b = std::max(xs[0], xs[1]);
+        if (n == 3) { a = std::min(a, xs[2]); b = std::max(b, xs[2]); }
+        fillRect(a, y, b - a + 1, 1, color);
+    }
+}
+
+void TFT_eSPI::fillCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color) {
+    for (int32_t dy = -r; dy <= r; dy++) {
+        int32_t dx = 0;
+        while ((dx + 1) * (dx + 1) + dy * dy <= r * r) dx++;
+        fillRect(x0 - dx, y0 + dy, 2 * dx + 1, 1, color);
+    }
+}
+
+void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* data) {
+    if (!data || _fb.empty()) return;
+    int32_t ax = x + _xDatum, ay = y + _yDatum;
+    for (int32_t row = 0; row < h; row++) {
+        int32_t sy = ay + row;
+        if (sy < _vpY || sy >= _vpH) continue;
+        for (int32_t col = 0; col < w; col++) {
+            int32_t sx = ax + col;
+            if (sx < _vpX || sx >= _vpW) continue;
+            uint16_t p = data[(size_t)row * w + col];
+            // Without swapBytes the buffer is already in panel (big endian) order
+            if (!_swapBytes) p = (uint16_t)((p >> 8) | (p << 8));
+            _fb[(size_t)sy * _width + sx] = store(p);
+            _pixels++;
+        }
+    }
+}
+
+void TFT_eSPI::setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h) {
+    _winX = x + _xDatum; _winY = y + _yDatum; _winW = w; _winH = h; _winPos = 0;
+}
+
+// Pixels stream into the address window left to right, top to bottom
+void TFT_eSPI::pushPixels(const void* data, uint32_t len) {
+    const uint16_t* px = (const uint16_t*)data;
+    if (!px || _fb.empty() || _winW <= 0) return;
+    for (uint32_t i = 0; i < len && _winPos < (uint32_t)(_winW * _winH); i++, _winPos++) {
+        int32_t sx = _winX + (int32_t)(_winPos % _winW), sy = _winY + (int32_t)(_winPos / _winW);
+        if (sx < 0 || sy < 0 || sx >= _width || sy >= _height) continue;
+        uint16_t p = px[i];
+        if (!_swapBytes) p = (uint16_t)((p >> 8) | (p << 8));
+        _fb[(size_t)sy * _width + sx] = p;
+        _pixels++;
+    }
+}
+
+uint16_t TFT_eSPI::readPixel(int32_t x, int32_t y) const {
+    if (x < 0 || y < 0 || x >= _width || y >= _height || _fb.empty()) return 0;
+    uint16_t p = _fb[(size_t)y * _width + x];
+    return _wireOrder ? (uint16_t)((p >> 8) | (p << 8)) : p;
+}
+
+void TFT_eSPI::drawChar(int32_t x, int32_t y, uint8_t c) {
+    int32_t s = _textSize;
+    if (_textBgColor != _textColor) fillRect(x, y, 6 * s, 8 * s, _textBgColor);
+    if (c == ' ') return;
+    // 5x7 cell footprint with a per-character pattern so text is distinguishable
+    for (int32_t col = 0; col < 5; col++) {
+        for (int32_t row = 0; row < 7; row++) {
+            if (((c * 7 + col * 3 + row) % 5) < 3) fillRect(x + col * s, y + row * s, s, s, _textColor);
+        }
+    }
+}
+
+size_t TFT_eSPI::write(uint8_t c) {
+    if (c == '\r') return 1;
+    if (c == '\n') {
+        _cursorX = 0;
+        _cursorY += 8 * _textSize;
+        return 1;
+    }
+    if (_wrapX && _cursorX + 6 * _textSize > width()) {
+        _cursorX = 0;
+        _cursorY += 8 * _textSize;
+    }
+    if (_wrapY && _cursorY >= height()) _cursorY = 0;
+    drawChar(_cursorX, _cursorY, c);
+    _cursorX += 6 * _textSize;
+    return 1;
+}
+
+bool TFT_eSPI::savePPM(const char* path) const {
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    fprintf(f, "P6\n%d %d\n255\n", _width, _height);
+    for (uint16_t p : _fb) {
+        uint8_t rgb[3] = { (uint8_t)((p >> 8) & 0xF8), (uint8_t)((p >> 3) & 0xFC), (uint8_t)((p << 3) & 0xF8) };
+        fwrite(rgb, 1, 3, f);
+    }
+    fclose(f);
+    return true;
+}
+
+void* TFT_eSprite::createSprite(int16_t w, int16_t h, uint8_t frames) {
+    (void)frames;
+    if (w <= 0 || h <= 0) return nullptr;
+    _initWidth = _width = w;
+    _initHeight = _height = h;
+    _fb.assign((size_t)w * h, TFT_BLACK);
+    resetViewport();
+    return _fb.data();
+}
+
+void TFT_eSprite::deleteSprite() {
+    _fb.clear();
+    _fb.shrink_to_fit();
+}
+
+void TFT_eSprite::pushSprite(int32_t x, int32_t y) {
+    if (!_tft || _fb.empty()) return;
+    bool swap = _tft->getSwapBytes();
+    _tft->setSwapBytes(false);
+    _tft->pushImage(x, y, _width, _height, _fb.data());
+    _tft->setSwapBytes(swap);
+}
@@ -0,0 +1,183 @@
+// Native shim: FreeRTOS semaphores, queues and tasks
+#include <Arduino.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <thread>
+
+struct NativeSemaphore {
+    std::mutex m;
+    std::condition_variable cv;
+    int count;
+    explicit NativeSemaphore(int initial) : count(initial) {}
+};
+
+SemaphoreHandle_t xSemaphoreCreateMutex() { return new NativeSemaphore(1); }
+SemaphoreHandle_t xSemaphoreCreateBinary() { return new NativeSemaphore(0); }
+void vSemaphoreDelete(SemaphoreHandle_t sem) { delete sem; }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks) {
+    std::unique_lock<std::mutex> l(sem->m);
+    auto ready = [sem] { return sem->count > 0; };
+    if (ticks == portMAX_DELAY) {
+        sem->cv.wait(l, ready);
+    } else if (!sem->cv.wait_for(l, std::chrono::milliseconds(ticks * portTICK_PERIOD_MS), ready)) {
+        return pdFALSE;
+    }
+    sem->count--;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+    {
+        std::lock_guard<std::mutex> l(sem->m);
+        if (sem->count > 0) return pdFALSE; // Mutex/binary: already available
+        sem->count++;
+    }
+    sem->cv.notify_one();
+    return pdTRUE;
+}
+
+struct NativeQueue {
+    std::mutex m;
+    std::condition_variable cv;
+    std::deque<std::vector<uint8_t>> items;
+    size_t length, itemSize;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    NativeQueue* q = new NativeQueue();
+    q->length = length;
+    q->itemSize = itemSize;
+    return q;
+}
+
+static BaseType_t queuePut(QueueHandle_t q, const void* item, TickType_t ticks, bool front, bool overwrite) {
+    std::unique_lock<std::mutex> l(q->m);
+    if (overwrite) {
+        q->items.clear();
+    } else {
+        auto space = [q] { return q->items.size() < q->length; };
+        if (ticks == portMAX_DELAY) q->cv.wait(l, space);
+        else if (!q->cv.wait_for(l, std::chrono::milliseconds(ticks * portTICK_PERIOD_MS), space)) return pdFALSE;
+    }
+    std::vector<uint8_t> data((const uint8_t*)item, (const uint8_t*)item + q->itemSize);
+    if (front) q->items.push_front(std::move(data));
+    else q->items.push_back(std::move(data));
+    q->cv.notify_all();
+    return pdTRUE;
+}
+
+static BaseType_t queueGet(QueueHandle_t q, void* item, TickType_t ticks, bool remove) {
+    std::unique_lock<std::mutex> l(q->m);
+    auto ready = [q] { return !q->items.empty(); };
+    if (ticks == portMAX_DELAY) q->cv.wait(l, ready);
+    else if (!q->cv.wait_for(l, std::chrono::milliseconds(ticks * portTICK_PERIOD_MS), ready)) return pdFALSE;
+    memcpy(item, q->items.front().data(), q->itemSize);
+    if (remove) {
+        q->items.pop_front();
+        q->cv.notify_all();
+    }
+    return pdTRUE;
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void* item, TickType_t ticks) { return queuePut(q, item, ticks, false, false); }
+BaseType_t xQueueSendToFront(QueueHandle_t q, const void* item, TickType_t ticks) { return queuePut(q, item, ticks, true, false); }
+BaseType_t xQueueOverwrite(QueueHandle_t q, const void* item) { return queuePut(q, item, 0, false, true); }
+BaseType_t xQueueReceive(QueueHandle_t q, void* item, TickType_t ticks) { return queueGet(q, item, ticks, true); }
+BaseType_t xQueuePeek(QueueHandle_t q, void* item, TickType_t ticks) { return queueGet(q, item, ticks, false); }
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) {
+    std::lock_guard<std::mutex> l(q->m);
+    return (UBaseType_t)q->items.size();
+}
+
+BaseType_t xQueueReset(QueueHandle_t q) {
+    std::lock_guard<std::mutex> l(q->m);
+    q->items.clear();
+    q->cv.notify_all();
+    return pdPASS;
+}
+
+struct NativeTask {
+    std::thread thread;
+    std::mutex m;
+    std::condition_variable cv;
+    uint32_t notifyValue = 0;
+    bool notified = false;
+    uint32_t stackDepth = 0;
+};
+
+static thread_local NativeTask* currentTask = nullptr;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackDepth,
+                                   void* param, UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t coreId) {
+    (void)name; (void)priority; (void)coreId;
+    NativeTask* task = new NativeTask();
+    task->stackDepth = stackDepth;
+    task->thread = std::thread([task, fn, param] {
+        currentTask = task;
+        fn(param);
+    });
+    task->thread.detach();
+    if (handle) *handle = task;
+    return pdPASS;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks * portTICK_PERIOD_MS));
+}
+
+TickType_t xTaskGetTickCount() { return (TickType_t)(millis() / portTICK_PERIOD_MS); }
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    return task ? task->stackDepth : 0;
+}
+
+// The Arduino main thread gets its task on first use
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    if (!currentTask) currentTask = new NativeTask();
+    return currentTask;
+}
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action) {
+    {
+        std::lock_guard<std::mutex> l(task->m);
+        switch (action) {
+        case eSetBits: task->notifyValue |= value; break;
+        case eIncrement: task->notifyValue++; break;
+        case eSetValueWithoutOverwrite:
+            if (task->notified) return pdFAIL;
+            task->notifyValue = value;
+            break;
+        case eSetValueWithOverwrite: task->notifyValue = value; break;
+        case eNoAction: break;
+        }
+        task->notified = true;
+    }
+    task->cv.notify_all();
+    return pdPASS;
+}
+
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action, BaseType_t* higherPriorityTaskWoken) {
+    if (higherPriorityTaskWoken) *higherPriorityTaskWoken = pdFALSE;
+    return xTaskNotify(task, value, action);
+}
+
+BaseType_t xTaskNotifyWait(uint32_t clearOnEntry, uint32_t clearOnExit, uint32_t* value, TickType_t ticks) {
+    NativeTask* task = xTaskGetCurrentTaskHandle();
+    std::unique_lock<std::mutex> l(task->m);
+    if (!task->notified) task->notifyValue &= ~clearOnEntry;
+    auto ready = [task] { return task->notified; };
+    bool got = true;
+    if (ticks == portMAX_DELAY) task->cv.wait(l, ready);
+    else got = task->cv.wait_for(l, std::chrono::milliseconds(ticks * portTICK_PERIOD_MS), ready);
+    if (value) *value = task->notifyValue;
+    if (!got) return pdFALSE;
+    task->notifyValue &= ~clearOnExit;
+    task->notified = false;
+    return pdTRUE;
+}
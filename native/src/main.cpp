@@ -0,0 +1,17 @@
+// Native entry point: the Arduino setup()/loop() contract
+#include <Arduino.h>
+#include <thread>
+
+void setup();
+void loop();
+void nativeStartStdinReader();
+
+int main() {
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    nativeStartStdinReader();
+    setup();
+    for (;;) {
+        loop();
+        std::this_thread::yield();
+    }
+}
@@ -5,8 +5,11 @@
 #include <HTTPClient.h>
 #include <Preferences.h>
 #include "esp_random.h"
+#include "esp_heap_caps.h"
 #include <FS.h>
+#include <LittleFS.h>
 #include <SPI.h>
+#include <algorithm>
 
 // --- FIX: Undefine macros for ArduinoJson conflicts ---
 #ifdef swap
@@ -23,7 +26,7 @@
 #include <Button2.h>
 #include <WiFiManager.h>
 #include <TFT_eSPI.h> 
-#include <QRCode.h>
+#include <qrcode.h>
 #include <JPEGDEC.h>
 
 // ============================================================
@@ -31,9 +34,33 @@
 // ============================================================
 
 #define ENABLE_ALBUM_ART 
-#define SPOTIFY_REFRESH_RATE_MS 1000 
 #define AP_NAME "SpotifySetup"
 #define SLEEP_TIMEOUT_MS 300000 // 5 Minutes
+#define PROGRESS_FRAME_MS 50 // Progress bar/clock redraw rate between polls
+#define CLOCK_RESYNC_MS 750 // Poll drift below this is latency jitter: keep the local clock
+#define SMART_PREV_MS 10000 // PREV past this point restarts the track instead
+#define OPTIMISTIC_TIMEOUT_MS 4000 // Unconfirmed commands roll back to the server state after this
+#define VOLUME_STEP 10        // % per press / hold repeat
+#define VOLUME_HOLD_MS 800    // Holding NEXT/PREV this long turns it into volume up/down
+#define VOLUME_REPEAT_MS 500  // Hold repeat rate
+#define VOLUME_MIN_GAP_MS 250 // Spacing between volume PUTs; steps in between are coalesced
+
+// --- POLL SCHEDULER ---
+// The playback clock fills in progress between polls, so polls only need to
+// catch changes: quickly after our own commands and at the track end, rarely
+// while nothing is playing. A 429's Retry-After always wins.
+#define POLL_PLAYING_MS     3000  // Steady state while playing
+#define POLL_PAUSED_MS      15000 // Paused or "No Active Device"
+#define POLL_FAST_MS        400   // After a command / once the track should have ended
+#define POLL_FAST_WINDOW_MS 3000  // How long after a command to keep polling fast
+#define POLL_TRACK_END_MS   300   // Poll this long after the expected track end
+#define POLL_STATS_EVERY    100   // Log poll counters every N polls
+#define JSON_ARENA_SIZE     8192  // Player-state parse arena (PSRAM if present)
+#define CMD_QUEUE_LEN       16    // Button commands waiting for spotifyTask
+
+// --- ACCESS TOKEN ---
+#define TOKEN_RENEW_MARGIN_MS (5 * 60 * 1000) // Renew this long before expires_in runs out
+#define TOKEN_RETRY_MS        30000           // Wait after a failed background renewal
 
 // --- PINS ---
 #define TFT_BL     22  
@@ -42,18 +69,99 @@
 #define PIN_NEXT   14
 
 // --- MEMORY ---
-#define JPG_BUFFER_SIZE 60000
+// Covers are decoded straight off the network / flash stream; only a small
+// window is kept for the decoder's backward seeks
+#define ART_STREAM_WINDOW (2 * JPEG_FILE_BUF_SIZE) // Holds the decoder's last read whole
+#define ART_STREAM_MAX    (512 * 1024) // Decoder size bound when no Content-Length
+
+// --- DISPLAY DMA ---
+// Large image pushes (album art) go out through two ping-pong bands in DMA
+// RAM: the CPU packs the next band while the previous one is on the wire.
+// Set PANEL_DMA to 0 for the blocking pushImage path (compare art.blit in
+// the stats output).
+#define PANEL_DMA        1
+#define PANEL_DMA_PIXELS 2048 // Pixels per band (x2 buffers)
+#ifdef ILI9488_DRIVER
+#define PANEL_BYTES_PER_PIXEL 3 // ILI9488 on SPI only takes 18-bit colour
+#else
+#define PANEL_BYTES_PER_PIXEL 2
+#endif
 
+// --- ALBUM ART PANE (Right side, above status bar) ---
+#define ART_PANE_X    240
+#define ART_PANE_Y    20
+#define ART_PANE_SIZE 240
+#define ART_CACHE_SLOTS 4 // Decoded covers kept for instant redraw (1 without PSRAM)
+#define ART_PREFETCH_COUNT 2 // Upcoming covers warmed from the playback queue
+
+// --- ALBUM ART FLASH CACHE (LittleFS, survives reboot) ---
+#define ART_FLASH_DIR       "/art"
+#define ART_FLASH_INDEX     "/art.idx"     // "<image id> <last used>" per line
+#define ART_FLASH_BUDGET    (1024 * 1024)  // Bytes of JPEGs kept on flash
+#define ART_FLASH_MAX_FILES 64
+
+// --- SMOOTH FONTS (LittleFS) ---
+// Anti-aliased .vlw fonts made with TFT_eSPI's Create_font sketch, one per
+// GLCD text size they replace. A missing file falls back to GLCD for that size.
+#define FONT_SMALL_FILE   "/fonts/small.vlw" // Size 1: device line
+#define FONT_BODY_FILE    "/fonts/body.vlw"  // Size 2: artist, album, time, popups
+#define FONT_TITLE_FILE   "/fonts/title.vlw" // Size 3: track title
+#define FONT_MAX_GLYPHS   4096
+#define GLYPH_CACHE_SLOTS 384 // Rendered glyphs kept in PSRAM (code point + size + colours)
+
+// --- MARQUEE ---
+// A title/artist too long for one line is rendered once into a strip and
+// scrolled through a window instead of being wrapped and cut off
+#define MARQUEE_FRAME_MS 40   // 25 fps
+#define MARQUEE_STEP_PX  2
+#define MARQUEE_PAUSE_MS 2000 // Held at the start of each pass
+#define MARQUEE_GAP_PX   48   // Blank between the end of the text and its repeat
+#define MARQUEE_MAX_W    4096 // Longer lines are wrapped as before
+
+// --- POPUP (centred box) ---
+#define POPUP_W 300
+#define POPUP_H 100
+#define POPUP_X ((480 - POPUP_W) / 2)
+#define POPUP_Y ((320 - POPUP_H) / 2)
+
+// --- UI LOOP ---
+// loop() sleeps on a task notification between events: button edges (GPIO
+// interrupt), new state or art from the other tasks, and its own render deadlines
+#define UI_BUTTON_POLL_MS   10    // Button2 polling while a button is down or bouncing
+#define UI_BUTTON_SETTLE_MS 100   // Keep polling this long after the last edge
+#define UI_MAX_WAIT_MS      1000  // Longest sleep, whatever the deadlines say
+#define UI_LOAD_REPORT_MS   30000 // Log core 1 idle % this often
+
+// --- LATENCY TRACING ---
+// Each press is timed from its button callback to the screen; "latency" on
+// the serial console prints p50/p95/p99 over the last LATENCY_WINDOW presses
+#define LATENCY_WINDOW 100 // Samples kept per command and stage
+#define LATENCY_TRACES 8   // Presses followed at once
+
+// --- METRICS ---
+// Counters, gauges and histograms for field tuning; "stats" on the serial
+// console prints them, "reset" starts a new measurement window
+#define METRIC_BUCKETS    100   // Histogram: 4 buckets per power of two of microseconds
+#define METRIC_TX_BUFFER  4096  // Serial TX ring, so a dump never blocks loop()
 
 // --- API ENDPOINTS ---
-const char* SPOT_PLAYER = "https://api.spotify.com/v1/me/player";
-const char* SPOT_NEXT   = "https://api.spotify.com/v1/me/player/next";
-const char* SPOT_PREV   = "https://api.spotify.com/v1/me/player/previous";
-const char* SPOT_PLAY   = "https://api.spotify.com/v1/me/player/play";
-const char* SPOT_PAUSE  = "https://api.spotify.com/v1/me/player/pause";
-const char* SPOT_VOLUME = "https://api.spotify.com/v1/me/player/volume";
-const char* SPOT_SEEK   = "https://api.spotify.com/v1/me/player/seek";
-const char* SPOT_LIB    = "https://api.spotify.com/v1/me/tracks"; 
+// Override at build time to point the device at a local mock (tools/mock_spotify)
+#ifndef SPOTIFY_API_BASE
+#define SPOTIFY_API_BASE "https://api.spotify.com"
+#endif
+#ifndef SPOTIFY_AUTH_URL
+#define SPOTIFY_AUTH_URL "https://spotauth-36097512380.europe-west1.run.app/"
+#endif
+
+const char* SPOT_PLAYER = SPOTIFY_API_BASE "/v1/me/player";
+const char* SPOT_NEXT   = SPOTIFY_API_BASE "/v1/me/player/next";
+const char* SPOT_PREV   = SPOTIFY_API_BASE "/v1/me/player/previous";
+const char* SPOT_PLAY   = SPOTIFY_API_BASE "/v1/me/player/play";
+const char* SPOT_PAUSE  = SPOTIFY_API_BASE "/v1/me/player/pause";
+const char* SPOT_VOLUME = SPOTIFY_API_BASE "/v1/me/player/volume";
+const char* SPOT_SEEK   = SPOTIFY_API_BASE "/v1/me/player/seek";
+const char* SPOT_LIB    = SPOTIFY_API_BASE "/v1/me/tracks"; 
+const char* SPOT_QUEUE  = SPOTIFY_API_BASE "/v1/me/player/queue";
 
 // --- COLORS (Standard ILI9488/TFT_eSPI colors) ---
 #define C_BLACK   TFT_BLACK
@@ -74,17 +182,98 @@ Preferences prefs;
 SemaphoreHandle_t dataMutex;
 TaskHandle_t spotifyTaskHandle;
 
+// Metrics registry (guarded by metricsMutex). Histograms come first so their
+// ids index metricBuckets; times are kept in microseconds.
+enum MetricId : uint8_t {
+    M_HTTP_PLAYER, M_HTTP_NEXT, M_HTTP_PREV, M_HTTP_PLAY, M_HTTP_PAUSE, M_HTTP_SEEK,
+    M_HTTP_VOLUME, M_HTTP_LIKE, M_HTTP_QUEUE, M_HTTP_OTHER, M_HTTP_TOKEN, M_HTTP_ART,
+    M_TLS_SESSION, M_DISPLAY_UPDATE, M_ART_FLASH, M_ART_CDN, M_ART_BLIT,
+    M_HISTOGRAMS,
+    M_POLL_OK = M_HISTOGRAMS, M_POLL_FAIL, M_HTTP_ERROR, M_HTTP_RATE_LIMITED,
+    M_FRAMES, M_FRAME_RECTS, M_FRAME_PUSHED, M_FRAME_DRAWN, M_GLYPH_HITS, M_GLYPH_MISSES,
+    M_ART_HITS, M_ART_MISSES, M_ART_EVICTIONS, M_ART_FLASH_HITS, M_ART_FLASH_MISSES, M_ART_FLASH_EVICTIONS,
+    M_GAUGES,
+    M_HEAP_FREE = M_GAUGES, M_HEAP_MIN, M_PSRAM_FREE, M_PSRAM_MIN, M_STACK_SPOTIFY, M_STACK_ART,
+    M_COUNT
+};
+struct Metric {
+    uint32_t count;              // Samples seen
+    int64_t sum;                 // Counter value / histogram total
+    int32_t value;               // Gauge: last sample
+    int32_t low, high;           // Gauge: water marks. Histogram: min/max
+};
+Metric metrics[M_COUNT] = {};
+uint32_t metricBuckets[M_HISTOGRAMS][METRIC_BUCKETS] = {};
+unsigned long metricsSince = 0;  // millis() of the last reset
+SemaphoreHandle_t metricsMutex = NULL;
+
 TFT_eSPI tft = TFT_eSPI();
 JPEGDEC jpeg;
-uint8_t* jpgBuffer = NULL;
+uint8_t* panelDmaBands[2] = { NULL, NULL }; // Internal RAM: PSRAM isn't DMA-capable
+bool panelDmaReady = false;
+
+// Album Art Pipeline: loop() posts requests, ArtTask downloads and decodes
+// off-screen, loop() blits the finished image in one push
+struct ArtRequest {
+    uint32_t generation;
+    bool prefetch;                   // Warm the caches only, never shown
+    char url[256];
+};
+QueueHandle_t artQueue;
+TaskHandle_t artTaskHandle;
+SemaphoreHandle_t artMutex;          // Guards the slots / artReady handoff
+SemaphoreHandle_t artWake;           // Given when ArtTask has new work
+char artPrefetchTrack[64] = "";      // Track whose queue ArtTask should prefetch
+volatile uint32_t artWantedGen = 0;  // Latest request; older work is stale
+uint16_t* artBack = NULL;            // Decode target (owned by ArtTask)
+bool artReady = false;
+uint32_t artReadyGen = 0;
+int artReadySlot = -1;               // Slot the loop should blit next
+char artPendingKey[64] = "";         // Cover ArtTask is currently fetching
+int artShownSlot = -1;               // Cover on the pane (loop() only), -1 = pane is black
+char artShownKey[64] = "";           // Its key when blitted, to notice the slot being reused
+
+// Decoded covers, most recent first by lastUsed. A redraw of a cover we
+// already have (wake-up, popup dismissed, track skipped back) is one push.
+struct ArtSlot {
+    char key[64];                    // Image id (last segment of the CDN url)
+    uint16_t* pixels;                // 240x240 RGB565, ready for pushImage
+    uint32_t lastUsed;
+};
+ArtSlot artSlots[ART_CACHE_SLOTS];
+int artSlotCount = 0;
+uint32_t artUseClock = 0;
+
+// On-flash JPEG cache (ArtTask only once running). The index lives in RAM;
+// recency from hits is written out with the next insert to spare the flash.
+struct ArtFileEntry {
+    char key[48];                    // Image id, also the file name
+    uint32_t size;
+    uint32_t lastUsed;
+};
+ArtFileEntry artFiles[ART_FLASH_MAX_FILES];
+int artFileCount = 0;
+uint32_t artFileBytes = 0;
+uint32_t artFileClock = 0;
+bool artFlashReady = false;
+int artSrcW = ART_PANE_SIZE;          // Size the JPEG decodes to, resampled
+int artSrcH = ART_PANE_SIZE;          // to exactly fill artBack
+const ArtRequest* artDecodeReq = NULL;
 
 Button2 btnPrev, btnPlay, btnNext;
 
 // Authentication
 char accesstoken[512] = ""; 
 char deviceId[40] = "";     
-const char* authurl = "https://spotauth-36097512380.europe-west1.run.app/";
+const char* authurl = SPOTIFY_AUTH_URL;
 char urlbuffer[1024];  
+// accesstoken is swapped under tokenMutex (held for copies only);
+// tokenRefreshMutex is held across a renewal so only one runs at a time
+char bearerAuth[520] = "";            // "Bearer <accesstoken>", rebuilt once per token
+SemaphoreHandle_t tokenMutex = NULL;
+SemaphoreHandle_t tokenRefreshMutex = NULL;
+volatile uint32_t tokenGeneration = 0; // Bumped with every new token
+unsigned long tokenRenewAt = 0;        // millis() for the background renewal, 0 = reactive only
 char g_lastSpotifyDeviceID[64] = ""; 
 
 // Data State
@@ -105,22 +294,183 @@ struct SpotifyState {
 SpotifyState sharedState;
 bool newDataAvailable = false;
 
+// Playback clock (guarded by dataMutex). Each poll anchors progress_ms to the
+// local time its response arrived; the position in between is extrapolated.
+struct PlaybackClock {
+    long positionMS;             // Position at anchorMillis
+    unsigned long anchorMillis;
+    long durationMS;
+    bool playing;
+    bool valid;                  // At least one poll has landed
+};
+PlaybackClock playbackClock = { 0, 0, 0, false, false };
+
+// Optimistic UI (guarded by dataMutex). Every command shows on screen when
+// pressed and stays pending until a poll confirms it. Until then it overrides
+// what polls report; after OPTIMISTIC_TIMEOUT_MS the server state wins.
+struct PendingState {
+    int skip;                    // Direction of unconfirmed skips (+1 next, -1 prev, 0 none)
+    bool restart;                // PREV restarting the current track
+    int skipsUnsent;             // Skips/restarts still waiting in the command queue
+    char skipFrom[64];           // Track the skips started from
+    unsigned long skipAt;
+    bool play;
+    bool playTarget;
+    unsigned long playAt;
+};
+PendingState pending = {};
+
+// Volume controller (guarded by dataMutex). Presses move a local target that
+// is shown at once; spotifyTask PUTs the latest target whenever the previous
+// PUT has finished (so one in flight at most), and polls can't overwrite the
+// target until the server reports it.
+struct VolumeController {
+    int target;                  // Level on screen, -1 = follow polls
+    int sent;                    // Last level PUT, -1 = none
+    unsigned long sentAt;
+    int8_t trace;                // Latency trace riding on the next PUT, -1 = none
+};
+VolumeController volumeCtl = { -1, -1, 0, -1 };
+char likedTrackID[64] = "";      // Liked from this device; cleared if the PUT fails
+
 // Display Tracking
 char lastTrackName[128] = ""; 
 char lastDeviceName[64] = ""; 
 int lastVolume = -1;          
+char lastPrefetchTrack[64] = ""; // Track whose upcoming covers were prefetched
 char lastImageUrl[256] = "";
 bool lastIsPlaying = false; 
 int lastBarWidth = -1; 
+int lastSkipShown = 0;        // Pending skip direction drawn in place of the play icon
+bool lastLikedShown = false;
+long lastClockSecond = -1;    // Elapsed second last printed
+unsigned long lastProgressFrame = 0;
+
+// Compositor (loop() only). Each screen region is drawn off-screen into its
+// own sprite, compared with the copy of what the panel shows, and only the
+// rows/columns that differ are pushed. Without PSRAM regions draw direct.
+enum RegionId : uint8_t { RGN_TITLE, RGN_ARTIST, RGN_ALBUM, RGN_PROGRESS, RGN_TIME, RGN_ICON, RGN_DEVICE, RGN_COUNT };
+struct Region {
+    int16_t x, y, w, h;
+    TFT_eSprite* back;           // Drawn each time the content changes
+    uint16_t* front;             // What the panel shows (wire order, PSRAM)
+    bool known;                  // front is valid; if not, the next draw pushes all of it
+    bool held;                   // Drawn under a popup, pushed when it's dismissed
+};
+Region regions[RGN_COUNT] = {
+#ifdef ENABLE_ALBUM_ART
+    { 0, 0, 240, 90 },           // Title
+    { 0, 90, 240, 70 },          // Artist
+    { 0, 160, 240, 116 },        // Album
+    { 0, 276, 480, 4 },          // Progress bar
+    { 0, 280, 190, 40 },         // Elapsed / duration
+    { 190, 280, 90, 40 },        // Liked badge + play/pause/skip icon
+    { 280, 280, 190, 40 },       // Device [volume]
+#else
+    { 0, 0, 480, 90 },
+    { 0, 90, 480, 70 },
+    { 0, 160, 480, 40 },
+    { 20, 220, 440, 10 },
+    { 0, 230, 360, 40 },
+    { 360, 230, 120, 40 },
+    { 0, 270, 380, 20 },
+#endif
+};
+bool compositorReady = false;
+// Popup save-under (loop() only): what the box covers, rebuilt from the
+// compositor's copies when it opens and pushed back when it's dismissed.
+// Regions under it keep drawing off-screen and are flushed afterwards.
+uint16_t* popupSaveUnder = NULL;     // POPUP_W x POPUP_H, wire order (PSRAM)
+bool popupShown = false;
+bool popupSaved = false;             // popupSaveUnder is valid
+
+// Marquees (loop() only): the strip holds the whole line plus the gap, and
+// each frame copies a window of it into the region and pushes just that.
+struct Marquee {
+    RegionId region;
+    TFT_eSprite* strip;          // NULL = the text fits and is drawn static
+    int16_t x, y, w, h;          // Window in region coordinates
+    int16_t offset;              // Strip column at the left edge of the window
+    unsigned long nextFrame;
+};
+Marquee marquees[2] = { { RGN_TITLE }, { RGN_ARTIST } };
+
+// Smooth fonts (loop() only). Metrics live in RAM and the alpha bitmaps stay
+// in the .vlw file; each glyph is read and blended once per colour pair, then
+// blitted from the PSRAM cache.
+struct VlwGlyph {
+    uint32_t code;
+    uint16_t w, h;
+    int16_t xAdvance, dY, dX;
+    uint32_t offset;             // Alpha bitmap in the file
+};
+struct SmoothFont {
+    const char* path;
+    File file;
+    VlwGlyph* glyphs;            // Sorted by code point, NULL = use GLCD
+    uint16_t count;
+    int16_t ascent;              // Baseline below the top of the line
+    int16_t lineHeight;
+};
+SmoothFont smoothFonts[3] = { { FONT_SMALL_FILE }, { FONT_BODY_FILE }, { FONT_TITLE_FILE } };
+struct GlyphEntry {
+    uint32_t code;
+    uint8_t size;                // GLCD size the font stands in for
+    uint16_t fg, bg;
+    uint16_t* pixels;            // w*h RGB565, wire order; NULL = free slot
+    uint32_t lastUsed;
+};
+GlyphEntry* glyphCache = NULL;
+uint32_t glyphUseClock = 0;
+uint32_t glyphHits = 0;         // Since the last frame, then moved to glyph.*
+uint32_t glyphMisses = 0;
+// Bytes sent to the panel by the frame in progress, against what redrawing
+// the touched regions whole would have cost. Folded into the frame.*
+// counters when the frame ends.
+uint32_t frameBytesPushed = 0;
+uint32_t frameBytesDrawn = 0;
+uint16_t frameRects = 0;
 
 // Logic Control
-// FIX: Added 'volatile' to thread-shared flags
-volatile bool triggerNext = false;
-volatile bool triggerPrev = false;
-volatile bool triggerPlay = false;
-volatile bool triggerLike = false;
-volatile int  triggerVolumeChange = 0;
-volatile bool triggerRefresh = false; // Triggers immediate API poll
+// Button input reaches spotifyTask as an ordered queue of commands, so quick
+// repeats are neither dropped nor held back. Adjacent commands that mean the
+// same thing are merged when drained (see commandMerge()).
+enum CommandType : uint8_t { CMD_NEXT, CMD_PREV, CMD_PLAY, CMD_VOLUME, CMD_LIKE, CMD_REFRESH };
+struct Command {
+    CommandType type;
+    int8_t arg;                  // PLAY: 1 = play, 0 = pause, -1 = toggle. PREV: 1 = restart,
+                                 // 0 = previous. PREV/NEXT: -1 = not on screen yet
+    int8_t trace;                // Slot in latencyTraces, -1 = untraced
+    unsigned long pressedAt;     // millis() when the input happened
+};
+QueueHandle_t cmdQueue = NULL;
+
+// Latency tracing (guarded by latencyMutex). A trace follows one press
+// through its stages (absolute micros(), 0 = not reached yet); finished
+// traces feed a rolling window per command type and stage.
+enum LatencyStage : uint8_t { LAT_DRAWN, LAT_SENT, LAT_RESPONSE, LAT_CONFIRMED, LAT_STAGES };
+#define LATENCY_COMMANDS 5       // next, prev, play, volume, like
+struct LatencyTrace {
+    bool active;
+    bool answered;               // Response is in; waiting for a poll to confirm it
+    bool confirmed;              // A poll confirmed it; the next frame closes the trace
+    CommandType type;
+    uint32_t pressUs;
+    uint32_t stageUs[LAT_STAGES];
+};
+struct LatencyWindow {
+    uint32_t samples[LATENCY_WINDOW]; // Microseconds since the press
+    uint16_t count;
+    uint16_t next;
+};
+LatencyTrace latencyTraces[LATENCY_TRACES] = {};
+LatencyWindow latencyWindows[LATENCY_COMMANDS][LAT_STAGES] = {};
+SemaphoreHandle_t latencyMutex = NULL;
+
+// Poll scheduler counters (spotifyTask only): the changed/issued ratio says
+// how much of the request volume is wasted on a given device
+uint32_t pollsIssued = 0;
+uint32_t pollsChanged = 0;
 
 unsigned long lastActivityTime = 0;
 // FIX: Added 'volatile' because Core 0 reads this while Core 1 writes it
@@ -142,43 +492,134 @@ bool isSavingTrack = false;
 unsigned long feedbackMessageClearTime = 0;
 bool showFeedbackMessage = false;
 
+// UI wake-ups (see uiWait()): notification bits set on the loop task
+#define UI_WAKE_BUTTON (1UL << 0) // GPIO edge on PREV/PLAY/NEXT
+#define UI_WAKE_DATA   (1UL << 1) // spotifyTask has new state
+#define UI_WAKE_ART    (1UL << 2) // A cover is ready to blit
+#define UI_WAKE_SERIAL (1UL << 3) // Console input waiting
+TaskHandle_t uiTaskHandle = NULL;
+unsigned long lastButtonEdge = 0;
+// Core 1 load: time loop() spent running vs blocked, per report window
+struct UiLoad {
+    unsigned long windowStart;  // millis()
+    unsigned long awakeSince;   // micros() when the last wait returned
+    uint64_t busyUs;
+    uint32_t wakes[5];          // button, data, art, serial, deadline
+} uiLoad = {};
+
 // ============================================================
 // === FORWARD DECLARATIONS (CRITICAL) ===
 // ============================================================
 void updateDisplay();
-void drawAlbumArt(const char* url);
+long playbackPosition(unsigned long now);
+bool playbackClockSync(bool sameTrack, long progressMS, long durationMS, bool playing, unsigned long arrivedAt);
+void playbackClockSetPlaying(bool playing);
+void drawProgress(bool force);
+long progressNextChange(unsigned long now);
+void optimisticSkip(int dir, bool restart);
+void optimisticPlay(bool playing);
+void volumeStep(int step);
+bool volumeService();
+void optimisticLike();
+bool optimisticReconcile(const char* trackId, long progressMS, bool* playing, int* volume);
+bool requestAlbumArt(const char* url);
+void blitAlbumArt();
+void artPaneClear();
+void artTask(void * parameter);
+void artFlashInit();
+void requestArtPrefetch(const char* trackId);
+const char* pickAlbumImage(JsonArray images);
 int JPEGDraw(JPEGDRAW *pDraw);
 void showPopup(const char* text, uint16_t color);
+void dismissPopup();
 void showQRCode(const char* data, const char* title, const char* footer);
 void clearScreen();
+void compositorInit();
+TFT_eSPI& regionBegin(RegionId id, uint16_t bg);
+void regionEnd(RegionId id);
+void compositorScreenCleared();
+void compositorEndFrame();
+void fontsInit();
+void drawText(TFT_eSPI& g, int x, int y, const char* text, uint8_t size, uint16_t fg, uint16_t bg, bool wrap);
+bool marqueeStart(Marquee& mq, int x, int y, const char* text, uint8_t size, uint16_t fg, uint16_t bg);
+void marqueeTick(unsigned long now);
+void panelPushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* pixels, int32_t stride = 0);
 bool wakeUp();
+void uiNotify(uint32_t bits);
+void uiWait();
+bool postCommand(CommandType type, int arg, uint32_t pressedUs = 0);
+int8_t latencyBegin(CommandType type, uint32_t pressedUs);
+void latencyDrop(int8_t trace);
+void latencyAnswered(int8_t trace, uint32_t sentUs, uint32_t responseUs);
+void latencyPolled();
+void latencyFrameDone();
+void latencyDump();
+void metricCount(MetricId id);
+void metricAdd(MetricId id, uint32_t n);
+void metricSet(MetricId id, int32_t value);
+void metricObserve(MetricId id, uint32_t us);
+void metricsSample();
+void consolePoll();
 void configModeCallback(WiFiManager *myWiFiManager);
 void connect_to_wifi();
 void gen_random_hex(char* buffer, int numBytes);
 
+void apiInit();
 boolean refreshAccessToken(char *targetBuffer, const char* baseurl);
-boolean getSpotifyData();
-void sendSpotifyCommand(const char* method, const char* endpoint);
-void saveToLiked();
-void setSpotifyVolume(int percent);
+bool renewAccessToken(uint32_t staleGeneration);
+struct ApiConnection;
+struct RequestUrl;
+uint32_t apiAuthorize(ApiConnection& conn);
+int getSpotifyData(bool* changed);
+struct RequestTiming;
+int spotifyRequest(const char* method, const char* url, RequestTiming* timing = NULL);
+int sendSpotifyCommand(const char* method, const RequestUrl& url, RequestTiming* timing = NULL);
+void saveToLiked(RequestTiming* timing = NULL);
+int setSpotifyVolume(int percent, RequestTiming* timing = NULL);
 void spotifyTask(void * parameter);
 
 // ============================================================
 // === HELPER FUNCTIONS ===
 // ============================================================
 
+bool panelSnapshot(int x, int y, int w, int h, uint16_t* out);
+
+// Repeated calls (countdowns) just redraw the box; what's under it is saved
+// the first time
 void showPopup(const char* text, uint16_t color) {
-    int boxW = 300; int boxH = 100;
-    int boxX = (480 - boxW) / 2;
-    int boxY = (320 - boxH) / 2;
-    
-    tft.fillRect(boxX, boxY, boxW, boxH, C_WHITE);
-    tft.drawRect(boxX, boxY, boxW, boxH, C_BLACK);
+    if (!popupShown) {
+        popupShown = true;
+        popupSaved = panelSnapshot(POPUP_X, POPUP_Y, POPUP_W, POPUP_H, popupSaveUnder);
+    }
+    tft.fillRect(POPUP_X, POPUP_Y, POPUP_W, POPUP_H, C_WHITE);
+    tft.drawRect(POPUP_X, POPUP_Y, POPUP_W, POPUP_H, C_BLACK);
     
-    tft.setCursor(boxX + 40, boxY + 40); 
-    tft.setTextColor(color, C_WHITE);
-    tft.setTextSize(2);
-    tft.println(text);
+    drawText(tft, POPUP_X + 40, POPUP_Y + 40, text, 2, color, C_WHITE, false);
+}
+
+void regionFlush(Region& r);
+
+// Put back what the popup covered, then push whatever changed underneath
+// while it was up. Falls back to a full repaint if the save-under is missing.
+void dismissPopup() {
+    if (!popupShown) return;
+    popupShown = false;
+    if (!popupSaved) {
+        clearScreen();
+        if (xSemaphoreTake(dataMutex, 10) == pdTRUE) {
+            newDataAvailable = true;
+            xSemaphoreGive(dataMutex);
+        }
+        return;
+    }
+    panelPushImage(POPUP_X, POPUP_Y, POPUP_W, POPUP_H, popupSaveUnder);
+    frameBytesPushed += (uint32_t)POPUP_W * POPUP_H * PANEL_BYTES_PER_PIXEL;
+    frameBytesDrawn += (uint32_t)POPUP_W * POPUP_H * PANEL_BYTES_PER_PIXEL;
+    frameRects++;
+    for (int i = 0; i < RGN_COUNT; i++) {
+        if (regions[i].held) regionFlush(regions[i]);
+    }
+    compositorEndFrame();
 }
 
 void clearScreen() {
@@ -189,67 +630,59 @@ void clearScreen() {
     lastImageUrl[0] = '\0';
     lastIsPlaying = !sharedState.isPlaying; 
     lastBarWidth = -1; // Reset bar tracker
+    lastClockSecond = -1;
+    artShownSlot = -1;
+    compositorScreenCleared();
 }
 
-// JPEG Callback
-int JPEGDraw(JPEGDRAW *pDraw) {
-    tft.pushImage(pDraw->x, pDraw->y, pDraw->iWidth, pDraw->iHeight, (uint16_t *)pDraw->pPixels);
-    return 1;
-}
-
-void drawAlbumArt(const char* url) {
-    if (WiFi.status() != WL_CONNECTED) return;
-    Serial.printf("Downloading Art: %s\n", url);
-    
-    WiFiClientSecure imgClient;
-    imgClient.setInsecure();
-    HTTPClient imgHttp;
-    imgHttp.useHTTP10(true);
-    
-    if (imgHttp.begin(imgClient, url)) {
-        int httpCode = imgHttp.GET();
-        if (httpCode == 200) {
-            int len = imgHttp.getSize();
-            if (len > 0 && len < JPG_BUFFER_SIZE) {
-                WiFiClient *stream = imgHttp.getStreamPtr();
-                int totalRead = 0;
-                while (imgHttp.connected() && (len > 0 || len == -1)) {
-                    size_t size = stream->available();
-                    if (size) {
-                        int c = stream->readBytes(jpgBuffer + totalRead, ((JPG_BUFFER_SIZE - totalRead) > size ? size : (JPG_BUFFER_SIZE - totalRead)));
-                        totalRead += c;
-                        if (len > 0) len -= c;
-                        if (totalRead >= JPG_BUFFER_SIZE) break;
-                    }
-                    delay(1);
-                }
+// Push a big-endian RGB565 image (PSRAM is fine) to the panel. With DMA up,
+// each band is packed into wire format and queued. pushPixelsDMA() first
+// waits for the previous band, so one transfer is in flight at a time and
+// packing a band overlaps the transfer of the one before it; the second
+// buffer keeps the band being packed clear of the one on the wire. A stride
+// wider than w pushes a sub-rectangle of a bigger buffer (compositor regions).
+void panelPushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* pixels, int32_t stride) {
+    if (stride <= 0) stride = w;
+    int32_t rowsPerBand = (w > 0) ? PANEL_DMA_PIXELS / w : 0;
+    if (!panelDmaReady || rowsPerBand == 0 || ((w * PANEL_BYTES_PER_PIXEL) & 1)) {
+        if (stride == w) {
+            tft.pushImage(x, y, w, h, pixels);
+        } else {
+            for (int32_t row = 0; row < h; row++) tft.pushImage(x, y + row, w, 1, pixels + (size_t)row * stride);
+        }
+        return;
+    }
 
-                if (totalRead > 0) {
-                    if (jpeg.openRAM(jpgBuffer, totalRead, JPEGDraw)) {
-                        // Center in Right Pane (X 240-480)
-                        int scale = 0;
-                        if (jpeg.getWidth() > 240) scale = JPEG_SCALE_HALF;
-                        if (jpeg.getWidth() > 480) scale = JPEG_SCALE_QUARTER;
-                        
-                        int outputWidth = jpeg.getWidth();
-                        int outputHeight = jpeg.getHeight();
-                        if (scale == JPEG_SCALE_HALF) { outputWidth /= 2; outputHeight /= 2; }
-                        if (scale == JPEG_SCALE_QUARTER) { outputWidth /= 4; outputHeight /= 4; }
-                        
-                        int xOff = 240 + (240 - outputWidth) / 2;
-                        int yOff = (280 - outputHeight) / 2; 
-
-                        jpeg.setPixelType(RGB565_BIG_ENDIAN);
-                        jpeg.decode(xOff, yOff, scale); 
-                        jpeg.close();
-                    }
-                }
-            } else {
-                Serial.println("Art too big for buffer");
+    bool swap = tft.getSwapBytes();
+    tft.setSwapBytes(false); // Bands are already in wire order
+    tft.startWrite();
+    tft.setAddrWindow(x, y, w, h);
+    int band = 0;
+    for (int32_t row = 0; row < h; row += rowsPerBand) {
+        int32_t rows = (h - row < rowsPerBand) ? h - row : rowsPerBand;
+        size_t count = (size_t)rows * w;
+        uint8_t* dst = panelDmaBands[band];
+        for (int32_t r = 0; r < rows; r++) {
+            const uint16_t* src = pixels + (size_t)(row + r) * stride;
+#ifdef ILI9488_DRIVER
+            // 18-bit panel: each pixel goes out as three bytes, 6 bits of colour in the top of each
+            for (int32_t i = 0; i < w; i++) {
+                uint16_t p = (uint16_t)((src[i] >> 8) | (src[i] << 8));
+                *dst++ = (p >> 8) & 0xF8;
+                *dst++ = (p >> 3) & 0xFC;
+                *dst++ = (p << 3) & 0xF8;
             }
+#else
+            memcpy(dst, src, w * sizeof(uint16_t));
+            dst += w * sizeof(uint16_t);
+#endif
         }
-        imgHttp.end();
+        tft.pushPixelsDMA((uint16_t*)panelDmaBands[band], count * PANEL_BYTES_PER_PIXEL / 2);
+        band ^= 1;
     }
+    tft.dmaWait();
+    tft.endWrite();
+    tft.setSwapBytes(swap);
 }
 
 void showQRCode(const char* data, const char* title, const char* footer) {
@@ -284,212 +717,717 @@ void showQRCode(const char* data, const char* title, const char* footer) {
     tft.println(footer);
 }
 
-void updateDisplay() {
-    bool trackChanged = strcmp(sharedState.trackName, lastTrackName) != 0;
+// --- COMPOSITOR --- (loop() only)
+void compositorInit() {
+    if (!psramFound()) {
+        Serial.println("Compositor: no PSRAM, regions draw direct");
+        return;
+    }
+    for (int i = 0; i < RGN_COUNT; i++) {
+        Region& r = regions[i];
+        r.back = new TFT_eSprite(&tft);
+        r.back->setColorDepth(16);
+        r.back->setAttribute(PSRAM_ENABLE, true);
+        r.front = (uint16_t*)ps_malloc((size_t)r.w * r.h * sizeof(uint16_t));
+        if (!r.back->createSprite(r.w, r.h) || !r.front) {
+            Serial.println("Compositor: sprite alloc failed, regions draw direct");
+            return;
+        }
+        r.known = false; // Boot screens are still up
+    }
+    popupSaveUnder = (uint16_t*)ps_malloc(POPUP_W * POPUP_H * sizeof(uint16_t));
+    compositorReady = true;
+}
 
-#ifdef ENABLE_ALBUM_ART
-    // --- ART LAYOUT (480x320) ---
-    // Left: Text (0-240). Right: Art (240-480). Bottom: Status (Y=280).
-    
-    if (trackChanged) {
-        // Clear Left Text Area
-        tft.fillRect(0, 0, 240, 276, C_BLACK); // Don't clear status bar area
-        strlcpy(lastTrackName, sharedState.trackName, sizeof(lastTrackName));
-        
-        // Track Title
-        tft.setViewport(0, 0, 240, 90);
-        tft.setTextWrap(true);
-        tft.setCursor(10, 20); 
-        tft.setTextColor(C_WHITE);
-        tft.setTextSize(3); 
-        tft.println(sharedState.trackName);
-        tft.resetViewport();
-        
-        // Artist
-        tft.setViewport(0, 90, 240, 70);
-        tft.setCursor(10, 10); 
-        tft.setTextColor(C_CYAN);
-        tft.setTextSize(2);
-        tft.println(sharedState.artistName);
-        tft.resetViewport();
+// Returns the surface to draw the region on, in region coordinates and
+// already filled with bg
+TFT_eSPI& regionBegin(RegionId id, uint16_t bg) {
+    Region& r = regions[id];
+    if (!compositorReady) {
+        tft.setViewport(r.x, r.y, r.w, r.h);
+        tft.fillRect(0, 0, r.w, r.h, bg);
+        return tft;
+    }
+    r.back->fillSprite(bg);
+    return *r.back;
+}
+
+// Push one changed band of a region and remember it as shown
+void regionPush(Region& r, int x, int y, int w, int h) {
+    const uint16_t* back = (const uint16_t*)r.back->getPointer();
+    panelPushImage(r.x + x, r.y + y, w, h, back + (size_t)y * r.w + x, r.w);
+    for (int row = y; row < y + h; row++) {
+        memcpy(r.front + (size_t)row * r.w + x, back + (size_t)row * r.w + x, w * sizeof(uint16_t));
+    }
+    frameBytesPushed += (uint32_t)w * h * PANEL_BYTES_PER_PIXEL;
+    frameRects++;
+}
+
+bool rectsOverlap(int ax, int ay, int aw, int ah, int bx, int by, int bw, int bh) {
+    return ax < bx + bw && bx < ax + aw && ay < by + bh && by < ay + ah;
+}
 
-        // Album
-        tft.setViewport(0, 160, 240, 120);
-        tft.setCursor(10, 0); 
-        tft.setTextColor(C_WHITE); 
-        tft.setTextSize(2);
-        tft.println(sharedState.albumName);
+void regionEnd(RegionId id) {
+    Region& r = regions[id];
+    frameBytesDrawn += (uint32_t)r.w * r.h * PANEL_BYTES_PER_PIXEL;
+    if (!compositorReady) {
         tft.resetViewport();
+        frameBytesPushed += (uint32_t)r.w * r.h * PANEL_BYTES_PER_PIXEL;
+        frameRects++;
+        return;
+    }
+    if (popupShown && rectsOverlap(r.x, r.y, r.w, r.h, POPUP_X, POPUP_Y, POPUP_W, POPUP_H)) {
+        r.held = true;
+        return;
+    }
+    regionFlush(r);
+}
 
-        tft.setTextWrap(false);
+// Diff the region against the panel row by row. Consecutive changed rows
+// form a band, trimmed to the leftmost/rightmost changed column, and each
+// band is one push; unchanged rows are never sent.
+void regionFlush(Region& r) {
+    r.held = false;
+    if (!r.known) {
+        regionPush(r, 0, 0, r.w, r.h);
+        r.known = true;
+        return;
     }
-    
-    // Progress Bar (Full width above status bar)
-    // Y=276, Height=4
-    int barWidth = map(sharedState.progressMS, 0, sharedState.durationMS, 0, 480);
-    
-    // Anti-Flicker Logic (Only draw if width changed)
-    if (barWidth != lastBarWidth) {
-        lastBarWidth = barWidth;
-        // Draw Green part (Active)
-        tft.fillRect(0, 276, barWidth, 4, C_GREEN);
-        // Draw Grey part (Remaining)
-        if (barWidth < 480) {
-             tft.fillRect(barWidth, 276, 480 - barWidth, 4, C_GREY);
+    const uint16_t* back = (const uint16_t*)r.back->getPointer();
+    int bandTop = -1, bandLeft = r.w, bandRight = -1;
+    for (int row = 0; row <= r.h; row++) {
+        if (row < r.h) {
+            const uint16_t* b = back + (size_t)row * r.w;
+            const uint16_t* f = r.front + (size_t)row * r.w;
+            if (memcmp(b, f, r.w * sizeof(uint16_t)) != 0) {
+                int left = 0, right = r.w - 1;
+                while (b[left] == f[left]) left++;
+                while (b[right] == f[right]) right--;
+                if (bandTop < 0) bandTop = row;
+                if (left < bandLeft) bandLeft = left;
+                if (right > bandRight) bandRight = right;
+                continue;
+            }
+        }
+        if (bandTop >= 0) {
+            regionPush(r, bandLeft, bandTop, bandRight - bandLeft + 1, row - bandTop);
+            bandTop = -1;
+            bandLeft = r.w;
+            bandRight = -1;
         }
     }
-    
-    // --- STATUS BAR (Y=280 to 320) ---
-    bool deviceChanged = (strcmp(sharedState.deviceName, lastDeviceName) != 0);
-    bool volumeChanged = (sharedState.volumePercent != lastVolume);
-    bool playStateChanged = (sharedState.isPlaying != lastIsPlaying);
+}
 
-    // Only redraw status bar background if track changed to clean up
-    if (trackChanged) tft.fillRect(0, 280, 480, 40, C_BLACK);
+// The panel was filled black behind the compositor's back (clearScreen, sleep)
+void compositorScreenCleared() {
+    if (!compositorReady) return;
+    for (int i = 0; i < RGN_COUNT; i++) {
+        memset(regions[i].front, 0, (size_t)regions[i].w * regions[i].h * sizeof(uint16_t));
+        regions[i].known = true;
+        regions[i].held = false;
+    }
+}
 
-    // 1. Time (Always update)
-    tft.setTextSize(2);
-    tft.setCursor(10, 290);
-    tft.setTextColor(C_WHITE, C_BLACK);
-    int curMin = sharedState.progressMS / 60000;
-    int curSec = (sharedState.progressMS / 1000) % 60;
-    int totMin = sharedState.durationMS / 60000;
-    int totSec = (sharedState.durationMS / 1000) % 60;
-    tft.printf("%02d:%02d / %02d:%02d", curMin, curSec, totMin, totSec);
-
-    // 2. Play/Pause Icon (Center) - Only if state changed
-    if (playStateChanged || trackChanged) {
-        lastIsPlaying = sharedState.isPlaying;
-        // Clear icon area first
-        tft.fillRect(220, 280, 40, 40, C_BLACK);
+// Rebuild what the panel shows in a rectangle from the compositor's copies:
+// region fronts, the cover on the art pane, black everywhere else (nothing
+// else draws there since the last fillScreen). False if any of it is unknown.
+bool panelSnapshot(int x, int y, int w, int h, uint16_t* out) {
+    if (!compositorReady || !out) return false;
+    memset(out, 0, (size_t)w * h * sizeof(uint16_t));
+    for (int i = 0; i < RGN_COUNT; i++) {
+        const Region& r = regions[i];
+        if (!rectsOverlap(r.x, r.y, r.w, r.h, x, y, w, h)) continue;
+        if (!r.known) return false;
+        int x0 = std::max(x, (int)r.x), x1 = std::min(x + w, r.x + r.w);
+        for (int row = std::max(y, (int)r.y); row < std::min(y + h, r.y + r.h); row++) {
+            memcpy(out + (size_t)(row - y) * w + (x0 - x), r.front + (size_t)(row - r.y) * r.w + (x0 - r.x),
+                   (x1 - x0) * sizeof(uint16_t));
+        }
+    }
+#ifdef ENABLE_ALBUM_ART
+    if (artShownSlot >= 0 && rectsOverlap(ART_PANE_X, ART_PANE_Y, ART_PANE_SIZE, ART_PANE_SIZE, x, y, w, h)) {
+        xSemaphoreTake(artMutex, portMAX_DELAY);
+        bool same = strcmp(artSlots[artShownSlot].key, artShownKey) == 0;
+        if (same) {
+            const uint16_t* art = artSlots[artShownSlot].pixels;
+            int x0 = std::max(x, ART_PANE_X), x1 = std::min(x + w, ART_PANE_X + ART_PANE_SIZE);
+            for (int row = std::max(y, ART_PANE_Y); row < std::min(y + h, ART_PANE_Y + ART_PANE_SIZE); row++) {
+                memcpy(out + (size_t)(row - y) * w + (x0 - x),
+                       art + (size_t)(row - ART_PANE_Y) * ART_PANE_SIZE + (x0 - ART_PANE_X),
+                       (x1 - x0) * sizeof(uint16_t));
+            }
+        }
+        xSemaphoreGive(artMutex);
+        if (!same) return false;
+    }
+#endif
+    return true;
+}
 
-        if(sharedState.isPlaying) {
-            // Playing -> Show Triangle (State)
-            tft.fillTriangle(230, 288, 230, 304, 245, 296, C_GREEN);
-        } else {
-            // Paused -> Show Bars (State)
-             tft.fillRect(230, 288, 5, 16, C_WHITE);
-             tft.fillRect(240, 288, 5, 16, C_WHITE);
+void compositorEndFrame() {
+    if (frameBytesDrawn == 0) return;
+    metricCount(M_FRAMES);
+    metricAdd(M_FRAME_RECTS, frameRects);
+    metricAdd(M_FRAME_PUSHED, frameBytesPushed);
+    metricAdd(M_FRAME_DRAWN, frameBytesDrawn);
+    if (glyphHits || glyphMisses) {
+        metricAdd(M_GLYPH_HITS, glyphHits);
+        metricAdd(M_GLYPH_MISSES, glyphMisses);
+        glyphHits = glyphMisses = 0;
+    }
+    frameBytesPushed = 0;
+    frameBytesDrawn = 0;
+    frameRects = 0;
+}
+
+// --- SMOOTH FONTS --- (loop() only)
+uint32_t vlwRead32(File& f) {
+    uint8_t b[4] = { 0, 0, 0, 0 };
+    f.read(b, 4);
+    return ((uint32_t)b[0] << 24) | ((uint32_t)b[1] << 16) | ((uint32_t)b[2] << 8) | b[3];
+}
+
+int vlwCompare(const void* a, const void* b) {
+    uint32_t ca = ((const VlwGlyph*)a)->code, cb = ((const VlwGlyph*)b)->code;
+    return (ca > cb) - (ca < cb);
+}
+
+// .vlw: 24-byte header (count, version, size, 0, ascent, descent), then 28
+// bytes of metrics per glyph, then the 8-bit alpha bitmaps in the same order
+bool fontLoad(SmoothFont& font) {
+    font.file = LittleFS.open(font.path, "r");
+    if (!font.file) return false;
+    uint32_t count = vlwRead32(font.file);
+    vlwRead32(font.file); // Version
+    vlwRead32(font.file); // Point size
+    vlwRead32(font.file);
+    int16_t ascent = (int16_t)vlwRead32(font.file);
+    int16_t descent = (int16_t)vlwRead32(font.file);
+    if (count == 0 || count > FONT_MAX_GLYPHS) {
+        font.file.close();
+        return false;
+    }
+    font.glyphs = (VlwGlyph*)ps_malloc(count * sizeof(VlwGlyph));
+    if (!font.glyphs) {
+        font.file.close();
+        return false;
+    }
+    uint32_t offset = 24 + count * 28;
+    for (uint32_t i = 0; i < count; i++) {
+        VlwGlyph& gl = font.glyphs[i];
+        gl.code = vlwRead32(font.file);
+        gl.h = (uint16_t)vlwRead32(font.file);
+        gl.w = (uint16_t)vlwRead32(font.file);
+        gl.xAdvance = (int16_t)vlwRead32(font.file);
+        gl.dY = (int16_t)vlwRead32(font.file);
+        gl.dX = (int16_t)vlwRead32(font.file);
+        vlwRead32(font.file);
+        gl.offset = offset;
+        offset += (uint32_t)gl.w * gl.h;
+        // Same line metrics as TFT_eSPI: tallest ascender + deepest descender
+        if (gl.dY > ascent) ascent = gl.dY;
+        if (gl.h - gl.dY > descent) descent = gl.h - gl.dY;
+    }
+    if (offset > font.file.size()) {
+        free(font.glyphs);
+        font.glyphs = NULL;
+        font.file.close();
+        return false;
+    }
+    qsort(font.glyphs, count, sizeof(VlwGlyph), vlwCompare);
+    font.count = count;
+    font.ascent = ascent;
+    font.lineHeight = ascent + descent;
+    return true;
+}
+
+void fontsInit() {
+    if (!psramFound()) {
+        Serial.println("Fonts: no PSRAM for the glyph cache, GLCD only");
+        return;
+    }
+    glyphCache = (GlyphEntry*)ps_malloc(GLYPH_CACHE_SLOTS * sizeof(GlyphEntry));
+    if (!glyphCache) return;
+    memset(glyphCache, 0, GLYPH_CACHE_SLOTS * sizeof(GlyphEntry));
+    for (int i = 0; i < 3; i++) {
+        SmoothFont& font = smoothFonts[i];
+        if (fontLoad(font)) Serial.printf("Font %s: %u glyphs, %d px lines\n", font.path, font.count, font.lineHeight);
+        else Serial.printf("Font %s: not loaded, size %d uses GLCD\n", font.path, i + 1);
+    }
+}
+
+const VlwGlyph* fontGlyph(const SmoothFont& font, uint32_t code) {
+    int lo = 0, hi = font.count - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        if (font.glyphs[mid].code == code) return &font.glyphs[mid];
+        if (font.glyphs[mid].code < code) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return NULL;
+}
+
+// Invalid or truncated sequences decode as U+FFFD and never overrun the string
+uint32_t utf8Next(const char*& p) {
+    uint8_t c = (uint8_t)*p++;
+    if (c < 0x80) return c;
+    int extra = (c >= 0xF0) ? 3 : (c >= 0xE0) ? 2 : (c >= 0xC0) ? 1 : 0;
+    if (extra == 0) return 0xFFFD;
+    uint32_t code = c & (0x3F >> extra);
+    for (int i = 0; i < extra; i++) {
+        if (((uint8_t)*p & 0xC0) != 0x80) return 0xFFFD;
+        code = (code << 6) | ((uint8_t)*p++ & 0x3F);
+    }
+    return code;
+}
+
+uint16_t blend565(uint8_t alpha, uint16_t fg, uint16_t bg) {
+    uint32_t a = alpha + (alpha >> 7); // 0..256
+    uint32_t r = (((fg >> 11) & 0x1F) * a + ((bg >> 11) & 0x1F) * (256 - a)) >> 8;
+    uint32_t g = (((fg >> 5) & 0x3F) * a + ((bg >> 5) & 0x3F) * (256 - a)) >> 8;
+    uint32_t b = ((fg & 0x1F) * a + (bg & 0x1F) * (256 - a)) >> 8;
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+// Pixels of a glyph blended over bg, from the cache or rendered into it
+const uint16_t* glyphPixels(uint8_t size, const VlwGlyph& gl, uint16_t fg, uint16_t bg) {
+    int victim = 0;
+    for (int i = 0; i < GLYPH_CACHE_SLOTS; i++) {
+        GlyphEntry& e = glyphCache[i];
+        if (e.pixels && e.code == gl.code && e.size == size && e.fg == fg && e.bg == bg) {
+            e.lastUsed = ++glyphUseClock;
+            glyphHits++;
+            return e.pixels;
         }
+        if (glyphCache[victim].pixels && (!e.pixels || e.lastUsed < glyphCache[victim].lastUsed)) victim = i;
     }
 
-    // 3. Device/Vol (Right) - Only if value changed
-    if (deviceChanged || volumeChanged || trackChanged) {
-        // Update trackers
-        strlcpy(lastDeviceName, sharedState.deviceName, sizeof(lastDeviceName));
-        lastVolume = sharedState.volumePercent;
+    glyphMisses++;
+    GlyphEntry& e = glyphCache[victim];
+    free(e.pixels);
+    e.pixels = (uint16_t*)ps_malloc((size_t)gl.w * gl.h * sizeof(uint16_t));
+    if (!e.pixels) return NULL;
+    File& f = smoothFonts[size - 1].file;
+    f.seek(gl.offset);
+    uint8_t alpha[64];
+    for (uint32_t i = 0, n = (uint32_t)gl.w * gl.h; i < n;) {
+        uint32_t chunk = (n - i < sizeof(alpha)) ? n - i : sizeof(alpha);
+        if (f.read(alpha, chunk) != chunk) memset(alpha, 0, chunk);
+        for (uint32_t j = 0; j < chunk; j++, i++) {
+            uint16_t p = blend565(alpha[j], fg, bg);
+            e.pixels[i] = (uint16_t)((p >> 8) | (p << 8));
+        }
+    }
+    e.code = gl.code;
+    e.size = size;
+    e.fg = fg;
+    e.bg = bg;
+    e.lastUsed = ++glyphUseClock;
+    return e.pixels;
+}
 
-        // Clear right area
-        tft.fillRect(280, 280, 200, 40, C_BLACK);
-        
-        // Viewport for Device Name (300, 290) Width 170
-        tft.setViewport(300, 290, 170, 30);
-        tft.setCursor(0, 5); // Relative to viewport
-        tft.setTextSize(1); // Small Font for Device Info
-        tft.setTextColor(C_WHITE, C_BLACK);
-        tft.print(sharedState.deviceName);
-        tft.print(" [");
-        tft.print(sharedState.volumePercent);
-        tft.print("%]");
-        tft.resetViewport();
-        tft.setTextSize(2); // Restore standard size
+// UTF-8 text with the smooth font standing in for GLCD size `size`, top-left
+// at (x, y); wrapped lines restart at x. Without that font it's GLCD, with
+// '?' for anything outside ASCII.
+void drawText(TFT_eSPI& g, int x, int y, const char* text, uint8_t size, uint16_t fg, uint16_t bg, bool wrap) {
+    const SmoothFont& font = smoothFonts[size - 1];
+    const char* p = text;
+    if (!glyphCache || !font.glyphs) {
+        g.setTextWrap(wrap);
+        g.setCursor(x, y);
+        g.setTextColor(fg, bg);
+        g.setTextSize(size);
+        while (*p) {
+            uint32_t code = utf8Next(p);
+            g.write((uint8_t)((code < 0x80) ? code : '?'));
+        }
+        g.setTextWrap(false);
+        return;
+    }
+
+    bool swap = g.getSwapBytes();
+    g.setSwapBytes(false); // Cached glyphs are in wire order already
+    int cx = x, cy = y;
+    while (*p) {
+        uint32_t code = utf8Next(p);
+        if (code == '\n') {
+            cx = x;
+            cy += font.lineHeight;
+            continue;
+        }
+        const VlwGlyph* gl = fontGlyph(font, code);
+        if (!gl) gl = fontGlyph(font, '?');
+        if (!gl) continue;
+        if (wrap && cx > x && cx + gl->xAdvance > g.width()) {
+            cx = x;
+            cy += font.lineHeight;
+            if (code == ' ') continue;
+        }
+        if (gl->w && gl->h) {
+            const uint16_t* px = glyphPixels(size, *gl, fg, bg);
+            if (px) g.pushImage(cx + gl->dX, cy + font.ascent - gl->dY, gl->w, gl->h, px);
+        }
+        cx += gl->xAdvance;
+    }
+    g.setSwapBytes(swap);
+}
+
+// Single-line extent of drawText() output
+int textWidth(const char* text, uint8_t size) {
+    const SmoothFont& font = smoothFonts[size - 1];
+    int width = 0;
+    while (*text) {
+        uint32_t code = utf8Next(text);
+        if (!glyphCache || !font.glyphs) {
+            width += 6 * size;
+            continue;
+        }
+        const VlwGlyph* gl = fontGlyph(font, code);
+        if (!gl) gl = fontGlyph(font, '?');
+        if (gl) width += gl->xAdvance;
+    }
+    return width;
+}
+
+int textHeight(uint8_t size) {
+    const SmoothFont& font = smoothFonts[size - 1];
+    return (glyphCache && font.glyphs) ? font.lineHeight : 8 * size;
+}
+
+// --- MARQUEE --- (loop() only)
+// Copy the window at mq.offset into the region's back buffer, wrapping
+// around the end of the strip
+void marqueeWindow(Marquee& mq) {
+    const Region& r = regions[mq.region];
+    uint16_t* back = (uint16_t*)r.back->getPointer();
+    const uint16_t* strip = (const uint16_t*)mq.strip->getPointer();
+    int stripW = mq.strip->width();
+    int first = (stripW - mq.offset < mq.w) ? stripW - mq.offset : mq.w;
+    for (int row = 0; row < mq.h; row++) {
+        uint16_t* dst = back + (size_t)(mq.y + row) * r.w + mq.x;
+        const uint16_t* src = strip + (size_t)row * stripW;
+        memcpy(dst, src + mq.offset, first * sizeof(uint16_t));
+        memcpy(dst + first, src, (mq.w - first) * sizeof(uint16_t));
+    }
+}
+
+// Called between regionBegin() and regionEnd() of the marquee's region.
+// Returns false if the text fits (or can't scroll), for the caller to draw
+// it static.
+bool marqueeStart(Marquee& mq, int x, int y, const char* text, uint8_t size, uint16_t fg, uint16_t bg) {
+    if (mq.strip) {
+        mq.strip->deleteSprite();
+        delete mq.strip;
+        mq.strip = NULL;
+    }
+    const Region& r = regions[mq.region];
+    int textW = textWidth(text, size);
+    int windowW = r.w - 2 * x;
+    if (!compositorReady || textW <= windowW || textW + MARQUEE_GAP_PX > MARQUEE_MAX_W) return false;
+
+    mq.strip = new TFT_eSprite(&tft);
+    mq.strip->setColorDepth(16);
+    mq.strip->setAttribute(PSRAM_ENABLE, true);
+    if (!mq.strip->createSprite(textW + MARQUEE_GAP_PX, textHeight(size))) {
+        delete mq.strip;
+        mq.strip = NULL;
+        return false;
+    }
+    mq.strip->fillSprite(bg);
+    drawText(*mq.strip, 0, 0, text, size, fg, bg, false);
+    mq.x = x;
+    mq.y = y;
+    mq.w = windowW;
+    mq.h = mq.strip->height();
+    if (mq.y + mq.h > r.h) mq.h = r.h - mq.y;
+    mq.offset = 0;
+    mq.nextFrame = millis() + MARQUEE_PAUSE_MS;
+    marqueeWindow(mq);
+    return true;
+}
+
+// Advance due marquees: one window copy and one push each, no text drawing
+void marqueeTick(unsigned long now) {
+    for (Marquee& mq : marquees) {
+        if (!mq.strip || (long)(now - mq.nextFrame) < 0) continue;
+        mq.offset += MARQUEE_STEP_PX;
+        if (mq.offset >= mq.strip->width()) mq.offset = 0;
+        mq.nextFrame = now + (mq.offset == 0 ? MARQUEE_PAUSE_MS : MARQUEE_FRAME_MS);
+        marqueeWindow(mq);
+        regionPush(regions[mq.region], mq.x, mq.y, mq.w, mq.h);
+        frameBytesDrawn += (uint32_t)mq.w * mq.h * PANEL_BYTES_PER_PIXEL;
+    }
+    compositorEndFrame();
+}
+
+// --- PLAYBACK CLOCK --- (all callers hold dataMutex)
+long playbackPosition(unsigned long now) {
+    long pos = playbackClock.positionMS;
+    if (playbackClock.playing) pos += (long)(now - playbackClock.anchorMillis);
+    if (playbackClock.durationMS > 0 && pos > playbackClock.durationMS) pos = playbackClock.durationMS;
+    return (pos < 0) ? 0 : pos;
+}
+
+// progress_ms is only as fresh as the poll, and the poll's latency varies by
+// a few hundred ms. Re-anchoring on every poll would make the bar twitch, so
+// while the same track keeps playing we only follow real seeks. Returns true
+// if the clock was re-anchored (seek, play state or track change).
+bool playbackClockSync(bool sameTrack, long progressMS, long durationMS, bool playing, unsigned long arrivedAt) {
+    bool wasValid = playbackClock.valid;
+    playbackClock.durationMS = durationMS;
+    playbackClock.valid = true;
+    if (wasValid && sameTrack && playing && playbackClock.playing &&
+        labs(progressMS - playbackPosition(arrivedAt)) < CLOCK_RESYNC_MS) return false;
+    playbackClock.positionMS = progressMS;
+    playbackClock.anchorMillis = arrivedAt;
+    playbackClock.playing = playing;
+    return true;
+}
+
+// Freeze or resume at the current position (optimistic play/pause)
+void playbackClockSetPlaying(bool playing) {
+    unsigned long now = millis();
+    playbackClock.positionMS = playbackPosition(now);
+    playbackClock.anchorMillis = now;
+    playbackClock.playing = playing;
+}
+
+// Progress bar + elapsed time. Runs every PROGRESS_FRAME_MS; the bar is
+// redrawn off-screen only when its width changes, so a frame pushes just the
+// columns it moved, and the time text only when the second changes.
+void drawProgress(bool force) {
+    if (!playbackClock.valid) return;
+    if (force) { lastBarWidth = -1; lastClockSecond = -1; }
+
+    long pos = playbackPosition(millis());
+    long dur = playbackClock.durationMS;
+    if (dur > 0) {
+        const Region& bar = regions[RGN_PROGRESS];
+        int barWidth = (int)((int64_t)pos * bar.w / dur);
+        if (barWidth != lastBarWidth) {
+            TFT_eSPI& g = regionBegin(RGN_PROGRESS, C_GREY);
+            g.fillRect(0, 0, barWidth, bar.h, C_GREEN);
+            regionEnd(RGN_PROGRESS);
+            lastBarWidth = barWidth;
+        }
+    }
+
+    long second = pos / 1000;
+    if (second == lastClockSecond) return;
+    lastClockSecond = second;
+    int curMin = pos / 60000;
+    int curSec = second % 60;
+    char text[24];
+    TFT_eSPI& g = regionBegin(RGN_TIME, C_BLACK);
+#ifdef ENABLE_ALBUM_ART
+    snprintf(text, sizeof(text), "%02d:%02d / %02d:%02d", curMin, curSec, (int)(dur / 60000), (int)((dur / 1000) % 60));
+    drawText(g, 10, 10, text, 2, C_WHITE, C_BLACK, false);
+#else
+    snprintf(text, sizeof(text), "%02d:%02d", curMin, curSec);
+    drawText(g, 20, 10, text, 2, C_WHITE, C_BLACK, false);
+#endif
+    regionEnd(RGN_TIME);
+}
+
+// Milliseconds until drawProgress() has something new to draw: the bar's next
+// pixel or the next second, whichever comes first. -1 while the clock is stopped.
+long progressNextChange(unsigned long now) {
+    if (!playbackClock.valid || !playbackClock.playing) return -1;
+    long pos = playbackPosition(now);
+    long dur = playbackClock.durationMS;
+    long wait = 1000 - pos % 1000;
+    if (dur > 0) {
+        if (pos >= dur) return -1; // Pinned at the end until a poll moves on
+        const Region& bar = regions[RGN_PROGRESS];
+        long px = (long)((int64_t)pos * bar.w / dur);
+        long nextPx = (long)(((int64_t)(px + 1) * dur + bar.w - 1) / bar.w);
+        wait = std::min(wait, nextPx - pos);
     }
+    return std::max(wait, 1L);
+}
+
+// --- OPTIMISTIC UI --- (all callers hold dataMutex)
+void optimisticSkip(int dir, bool restart) {
+    if (pending.skip == 0 && !pending.restart) strlcpy(pending.skipFrom, sharedState.trackID, sizeof(pending.skipFrom));
+    if (restart) pending.restart = true;
+    else pending.skip = dir;
+    pending.skipsUnsent++;
+    pending.skipAt = millis();
+    // Either way the user expects to hear the start of a track
+    playbackClock.positionMS = 0;
+    playbackClock.anchorMillis = pending.skipAt;
+    newDataAvailable = true;
+}
+
+void optimisticPlay(bool playing) {
+    sharedState.isPlaying = playing;
+    playbackClockSetPlaying(playing);
+    pending.play = true;
+    pending.playTarget = playing;
+    pending.playAt = millis();
+    newDataAvailable = true;
+}
+
+// Moves the volume target from what's on screen and wakes spotifyTask
+void volumeStep(int step) {
+    int vol = ((volumeCtl.target >= 0) ? volumeCtl.target : sharedState.volumePercent) + step;
+    if (vol > 100) vol = 100;
+    if (vol < 0) vol = 0;
+    volumeCtl.target = vol;
+    sharedState.volumePercent = vol;
+    newDataAvailable = true;
+    postCommand(CMD_VOLUME, 0);
+}
+
+void optimisticLike() {
+    strlcpy(likedTrackID, sharedState.trackID, sizeof(likedTrackID));
+    newDataAvailable = true;
+}
+
+// Folds a poll result into the pending commands: confirmed ones are cleared,
+// the rest keep overriding the polled values until they time out. Returns
+// true while a skip is still in flight, so the clock isn't dragged back to
+// the old track's position.
+bool optimisticReconcile(const char* trackId, long progressMS, bool* playing, int* volume) {
+    unsigned long now = millis();
+    if ((pending.skip != 0 || pending.restart) && pending.skipsUnsent == 0) {
+        bool landed = (trackId && strcmp(trackId, pending.skipFrom) != 0) ||
+                      (pending.skip == 0 && progressMS < SMART_PREV_MS);
+        if (landed || now - pending.skipAt > OPTIMISTIC_TIMEOUT_MS) {
+            if (!landed) Serial.println("Optimistic: skip not confirmed, rolling back");
+            pending.skip = 0;
+            pending.restart = false;
+        }
+    }
+    if (pending.play) {
+        if (*playing == pending.playTarget) pending.play = false;
+        else if (now - pending.playAt > OPTIMISTIC_TIMEOUT_MS) {
+            Serial.println("Optimistic: play state not confirmed, rolling back");
+            pending.play = false;
+        } else *playing = pending.playTarget;
+    }
+    if (volumeCtl.target >= 0) {
+        bool allSent = (volumeCtl.target == volumeCtl.sent);
+        if (allSent && *volume == volumeCtl.target) volumeCtl.target = -1;
+        else if (allSent && now - volumeCtl.sentAt > OPTIMISTIC_TIMEOUT_MS) {
+            Serial.println("Optimistic: volume not confirmed, rolling back");
+            volumeCtl.target = -1;
+        } else *volume = volumeCtl.target;
+    }
+    return pending.skip != 0 || pending.restart;
+}
+
+// Status bar glyphs for pending state
+void drawSkipIcon(TFT_eSPI& g, int x, int y, int dir) {
+    if (dir > 0) {
+        g.fillTriangle(x, y, x, y + 16, x + 9, y + 8, C_CYAN);
+        g.fillTriangle(x + 9, y, x + 9, y + 16, x + 18, y + 8, C_CYAN);
+    } else {
+        g.fillTriangle(x + 9, y, x + 9, y + 16, x, y + 8, C_CYAN);
+        g.fillTriangle(x + 18, y, x + 18, y + 16, x + 9, y + 8, C_CYAN);
+    }
+}
+
+void drawLikedBadge(TFT_eSPI& g, int x, int y) {
+    g.fillCircle(x + 5, y + 5, 4, C_MAGENTA);
+    g.fillCircle(x + 13, y + 5, 4, C_MAGENTA);
+    g.fillTriangle(x + 1, y + 7, x + 17, y + 7, x + 9, y + 16, C_MAGENTA);
+}
+
+// Each block redraws its region off-screen only when what it shows changed;
+// the compositor then pushes just the pixels that differ from the panel.
+void updateDisplay() {
+    uint32_t start = micros();
+    bool trackChanged = strcmp(sharedState.trackName, lastTrackName) != 0;
+    bool deviceChanged = (strcmp(sharedState.deviceName, lastDeviceName) != 0);
+    bool volumeChanged = (sharedState.volumePercent != lastVolume);
+    bool liked = likedTrackID[0] && strcmp(likedTrackID, sharedState.trackID) == 0;
+    bool iconChanged = (sharedState.isPlaying != lastIsPlaying) || (pending.skip != lastSkipShown) ||
+                       (liked != lastLikedShown);
 
+#ifdef ENABLE_ALBUM_ART
+    // --- ART LAYOUT (480x320) ---
+    // Left: Text (0-240). Right: Art (240-480). Bottom: Status (Y=280).
+    const int textX = 10;
 #else
     // --- TEXT LAYOUT ---
-    // Same logic applies
+    const int textX = 20;
+#endif
+
     if (trackChanged) {
-        tft.fillRect(0, 0, 480, 200, C_BLACK); 
         strlcpy(lastTrackName, sharedState.trackName, sizeof(lastTrackName));
-        
-        tft.setTextWrap(true);
 
         // Track Title (Size 3)
-        tft.setViewport(0, 0, 480, 90);
-        tft.setCursor(20, 20);
-        tft.setTextColor(C_WHITE, C_BLACK);
-        tft.setTextSize(3); 
-        tft.println(sharedState.trackName);
-        tft.resetViewport();
-        
+        // Title/artist too long for one line scroll as a marquee
+        TFT_eSPI& title = regionBegin(RGN_TITLE, C_BLACK);
+        if (!marqueeStart(marquees[0], textX, 20, sharedState.trackName, 3, C_WHITE, C_BLACK)) {
+            drawText(title, textX, 20, sharedState.trackName, 3, C_WHITE, C_BLACK, true);
+        }
+        regionEnd(RGN_TITLE);
+
         // Artist Name (Size 2)
-        tft.setViewport(0, 90, 480, 70);
-        tft.setCursor(20, 10); 
-        tft.setTextColor(C_CYAN, C_BLACK);
-        tft.setTextSize(2);
-        tft.println(sharedState.artistName);
-        tft.resetViewport();
-        
-        // Album Name (Size 2)
-        tft.setViewport(0, 160, 480, 40);
-        tft.setCursor(20, 0); 
-        tft.setTextColor(C_WHITE, C_BLACK);
-        tft.setTextSize(2);
-        tft.println(sharedState.albumName);
-        tft.resetViewport();
-        
-        tft.setTextWrap(false); 
-    }
-    
-    // Progress Bar
-    if (sharedState.durationMS > 0) {
-        int barWidth = map(sharedState.progressMS, 0, sharedState.durationMS, 0, 440);
-        
-        // Anti-Flicker for Text Layout
-        if (barWidth != lastBarWidth) {
-            lastBarWidth = barWidth;
-            tft.fillRect(20, 220, barWidth, 10, C_GREEN); 
-            if (barWidth < 440) {
-                tft.fillRect(20 + barWidth, 220, 440 - barWidth, 10, C_GREY); 
-            }
+        TFT_eSPI& artist = regionBegin(RGN_ARTIST, C_BLACK);
+        if (!marqueeStart(marquees[1], textX, 10, sharedState.artistName, 2, C_CYAN, C_BLACK)) {
+            drawText(artist, textX, 10, sharedState.artistName, 2, C_CYAN, C_BLACK, true);
         }
+        regionEnd(RGN_ARTIST);
+
+        // Album Name (Size 2)
+        TFT_eSPI& album = regionBegin(RGN_ALBUM, C_BLACK);
+        drawText(album, textX, 0, sharedState.albumName, 2, C_WHITE, C_BLACK, true);
+        regionEnd(RGN_ALBUM);
     }
-    
-    // Status Bar Logic
-    tft.setTextSize(2);
-    tft.setCursor(20, 240);
-    tft.setTextColor(C_WHITE, C_BLACK);
-    int curMin = sharedState.progressMS / 60000;
-    int curSec = (sharedState.progressMS / 1000) % 60;
-    tft.printf("%02d:%02d", curMin, curSec);
 
-    bool playStateChanged = (sharedState.isPlaying != lastIsPlaying);
-    
-    if (playStateChanged || trackChanged) {
+    // Progress Bar + Time (from the playback clock)
+    drawProgress(trackChanged);
+
+    // Liked badge + Play/Pause Icon - Only if state changed
+    if (iconChanged || trackChanged) {
         lastIsPlaying = sharedState.isPlaying;
-        
-        // Play/Pause Icon
-        tft.fillRect(400, 230, 40, 30, C_BLACK);
-        if(sharedState.isPlaying) {
-             // Play Triangle
-             tft.fillTriangle(400, 240, 400, 256, 415, 248, C_GREEN);
+        lastSkipShown = pending.skip;
+        lastLikedShown = liked;
+#ifdef ENABLE_ALBUM_ART
+        const int badgeX = 2, badgeY = 7, iconX = 40, iconY = 8;
+#else
+        const int badgeX = 10, badgeY = 9, iconX = 40, iconY = 10;
+#endif
+        TFT_eSPI& g = regionBegin(RGN_ICON, C_BLACK);
+        if (liked) drawLikedBadge(g, badgeX, badgeY);
+        if (pending.skip != 0) {
+            // Skip sent, new track not confirmed yet
+            drawSkipIcon(g, iconX - 2, iconY, pending.skip);
+        } else if (sharedState.isPlaying) {
+            // Playing -> Show Triangle (State)
+            g.fillTriangle(iconX, iconY, iconX, iconY + 16, iconX + 15, iconY + 8, C_GREEN);
         } else {
-             // Pause Bars
-             tft.fillRect(400, 240, 5, 16, C_WHITE);
-             tft.fillRect(410, 240, 5, 16, C_WHITE);
+            // Paused -> Show Bars (State)
+            g.fillRect(iconX, iconY, 5, 16, C_WHITE);
+            g.fillRect(iconX + 10, iconY, 5, 16, C_WHITE);
         }
+        regionEnd(RGN_ICON);
     }
-    
-    // Status Line
-    if (strcmp(sharedState.deviceName, lastDeviceName) != 0 || sharedState.volumePercent != lastVolume) {
+
+    // Device/Vol - Only if value changed
+    if (deviceChanged || volumeChanged || trackChanged) {
         strlcpy(lastDeviceName, sharedState.deviceName, sizeof(lastDeviceName));
         lastVolume = sharedState.volumePercent;
-        
-        tft.fillRect(0, 270, 480, 20, C_BLACK); 
-        
-        // Viewport for Device (Text Layout)
-        tft.setViewport(20, 270, 360, 20);
-        tft.setCursor(0, 5); 
-        tft.setTextSize(1);
-        tft.setTextColor(C_WHITE, C_BLACK);
-        tft.print(sharedState.deviceName);
-        tft.print(" [Vol ");
-        tft.print(sharedState.volumePercent);
-        tft.print("%]");
-        tft.resetViewport();
-        tft.setTextSize(2);
-    }
+
+        // Small Font for Device Info
+        char text[96];
+        TFT_eSPI& g = regionBegin(RGN_DEVICE, C_BLACK);
+#ifdef ENABLE_ALBUM_ART
+        snprintf(text, sizeof(text), "%s [%d%%]", sharedState.deviceName, sharedState.volumePercent);
+        drawText(g, 20, 15, text, 1, C_WHITE, C_BLACK, false);
+#else
+        snprintf(text, sizeof(text), "%s [Vol %d%%]", sharedState.deviceName, sharedState.volumePercent);
+        drawText(g, 20, 5, text, 1, C_WHITE, C_BLACK, false);
 #endif
+        regionEnd(RGN_DEVICE);
+    }
+
+    compositorEndFrame();
+    metricObserve(M_DISPLAY_UPDATE, micros() - start);
+    latencyFrameDone();
 }
 
 // --- FIX: Updated WakeUp to handle redraw and force refresh ---
@@ -508,7 +1446,7 @@ bool wakeUp() {
         }
 
         // 2. Force the Background Task to fetch new data immediately
-        triggerRefresh = true;
+        postCommand(CMD_REFRESH, 0);
 
         Serial.println("WakeUp: Requesting immediate update...");
         return true; 
@@ -525,20 +1463,133 @@ void gen_random_hex(char* buffer, int numBytes) {
   buffer[numBytes * 2] = '\0';
 }
 
+// ============================================================
+// === UI WAKE-UPS ===
+// ============================================================
+// Edges only wake loop(); Button2 still debounces and times the presses
+void IRAM_ATTR onButtonEdge() {
+    BaseType_t woken = pdFALSE;
+    if (uiTaskHandle) xTaskNotifyFromISR(uiTaskHandle, UI_WAKE_BUTTON, eSetBits, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+// Other tasks call this after publishing something for loop() to draw
+void uiNotify(uint32_t bits) {
+    if (uiTaskHandle) xTaskNotify(uiTaskHandle, bits, eSetBits);
+}
+
+// How long loop() may sleep: until the nearest render deadline, or a short
+// poll while Button2 needs to see the pins (press held, or still bouncing)
+unsigned long uiNextWake(unsigned long now) {
+    if (btnPrev.isPressed() || btnPlay.isPressed() || btnNext.isPressed() ||
+        now - lastButtonEdge < UI_BUTTON_SETTLE_MS) return UI_BUTTON_POLL_MS;
+
+    long wait = UI_MAX_WAIT_MS;
+    if (showFeedbackMessage) wait = std::min(wait, (long)(feedbackMessageClearTime - now) + 1);
+    if (isSleeping) return std::max(wait, 0L);
+    wait = std::min(wait, (long)(lastActivityTime + SLEEP_TIMEOUT_MS - now) + 1);
+
+    if (xSemaphoreTake(dataMutex, 0) != pdTRUE) return UI_BUTTON_POLL_MS;
+    // State spotifyTask published while loop() couldn't take the mutex
+    if (newDataAvailable) wait = std::min(wait, (long)UI_BUTTON_POLL_MS);
+    long progress = progressNextChange(now);
+    xSemaphoreGive(dataMutex);
+    if (progress >= 0) {
+        long frameGap = PROGRESS_FRAME_MS - (long)(now - lastProgressFrame);
+        wait = std::min(wait, std::max(progress, frameGap));
+    }
+
+    if (!showFeedbackMessage && !isResetting) {
+        for (const Marquee& mq : marquees) {
+            if (mq.strip) wait = std::min(wait, (long)(mq.nextFrame - now));
+        }
+        // A cover blitAlbumArt() couldn't take artMutex for
+        if (artReady) wait = std::min(wait, (long)UI_BUTTON_POLL_MS);
+    }
+    return std::max(wait, 0L);
+}
+
+// Top of loop(): block until a notification or the next deadline, and keep
+// the busy/blocked split for the periodic core 1 load line
+void uiWait() {
+    unsigned long start = micros();
+    if (uiLoad.awakeSince != 0) uiLoad.busyUs += start - uiLoad.awakeSince;
+    else uiLoad.windowStart = millis();
+
+    unsigned long now = millis();
+    uint32_t bits = 0;
+    if (xTaskNotifyWait(0, UINT32_MAX, &bits, uiNextWake(now) / portTICK_PERIOD_MS) != pdTRUE) bits = 0;
+    uiLoad.awakeSince = micros();
+    now = millis();
+
+    if (bits & UI_WAKE_BUTTON) { lastButtonEdge = now; uiLoad.wakes[0]++; }
+    if (bits & UI_WAKE_DATA) uiLoad.wakes[1]++;
+    if (bits & UI_WAKE_ART) uiLoad.wakes[2]++;
+    if (bits & UI_WAKE_SERIAL) uiLoad.wakes[3]++;
+    if (bits == 0) uiLoad.wakes[4]++;
+
+    unsigned long window = now - uiLoad.windowStart;
+    if (window >= UI_LOAD_REPORT_MS) {
+        uint64_t windowUs = (uint64_t)window * 1000;
+        uint64_t idle = uiLoad.busyUs < windowUs ? windowUs - uiLoad.busyUs : 0;
+        Serial.printf("UI: core 1 idle %lu.%lu%%, wakes button=%lu data=%lu art=%lu serial=%lu deadline=%lu\n",
+                      (unsigned long)(idle * 100 / windowUs), (unsigned long)(idle * 1000 / windowUs % 10),
+                      (unsigned long)uiLoad.wakes[0], (unsigned long)uiLoad.wakes[1],
+                      (unsigned long)uiLoad.wakes[2], (unsigned long)uiLoad.wakes[3],
+                      (unsigned long)uiLoad.wakes[4]);
+        uiLoad = {};
+        uiLoad.windowStart = now;
+        uiLoad.awakeSince = micros();
+    }
+}
+
 // ============================================================
 // === BUTTON CALLBACKS ===
 // ============================================================
-void onPrevClick(Button2& btn) { if (!wakeUp()) { Serial.println("BTN: PREV"); triggerPrev = true; } }
-void onNextClick(Button2& btn) { if (!wakeUp()) { Serial.println("BTN: NEXT"); triggerNext = true; } }
+void onPrevClick(Button2& btn) {
+    uint32_t pressedUs = micros();
+    if (btn.wasPressedFor() > VOLUME_HOLD_MS) return; // Release after a volume hold
+    if (!wakeUp()) {
+        Serial.println("BTN: PREV");
+        if (xSemaphoreTake(dataMutex, 10) == pdTRUE) {
+            // Smart Previous: decided here, against the position the user sees
+            bool restart = playbackPosition(millis()) > SMART_PREV_MS;
+            optimisticSkip(-1, restart);
+            postCommand(CMD_PREV, restart ? 1 : 0, pressedUs);
+            xSemaphoreGive(dataMutex);
+        } else {
+            // A poll holds the state: spotifyTask decides and shows it
+            postCommand(CMD_PREV, -1, pressedUs);
+        }
+    }
+}
+void onNextClick(Button2& btn) {
+    uint32_t pressedUs = micros();
+    if (btn.wasPressedFor() > VOLUME_HOLD_MS) return; // Release after a volume hold
+    if (!wakeUp()) {
+        Serial.println("BTN: NEXT");
+        if (xSemaphoreTake(dataMutex, 10) == pdTRUE) {
+            optimisticSkip(1, false);
+            postCommand(CMD_NEXT, 0, pressedUs);
+            xSemaphoreGive(dataMutex);
+        } else {
+            postCommand(CMD_NEXT, -1, pressedUs);
+        }
+    }
+}
 void onPlayClick(Button2& btn) { 
+    uint32_t pressedUs = micros();
     if (!wakeUp()) {
         if (!isSavingTrack) {
             Serial.println("BTN: PLAY");
-            triggerPlay = true;
             if (xSemaphoreTake(dataMutex, 10) == pdTRUE) {
-                sharedState.isPlaying = !sharedState.isPlaying;
-                newDataAvailable = true;
+                optimisticPlay(!sharedState.isPlaying);
+                // The command carries the state the user asked for, not a toggle
+                postCommand(CMD_PLAY, sharedState.isPlaying ? 1 : 0, pressedUs);
                 xSemaphoreGive(dataMutex);
+            } else {
+                // A poll holds the state: spotifyTask resolves the toggle
+                postCommand(CMD_PLAY, -1, pressedUs);
             }
         }
         isSavingTrack = false; 
@@ -546,14 +1597,660 @@ void onPlayClick(Button2& btn) {
 }
 
 // ============================================================
-// === API IMPLEMENTATION ===
+// === COMMAND QUEUE ===
 // ============================================================
+// pressedUs is micros() at the input (0 = now); it starts the latency trace
+bool postCommand(CommandType type, int arg, uint32_t pressedUs) {
+    if (!cmdQueue) return false;
+    Command cmd = { type, (int8_t)arg, latencyBegin(type, pressedUs ? pressedUs : micros()), millis() };
+    if (xQueueSend(cmdQueue, &cmd, 0) != pdTRUE) {
+        Serial.println("CMD: Queue full, input dropped");
+        latencyDrop(cmd.trace);
+        return false;
+    }
+    return true;
+}
 
-boolean refreshAccessToken(char *targetBuffer, const char* baseurl) {
+// Folds `next` into `cmd` when sending both would be redundant. Skips are
+// never merged: N presses of NEXT are N skips.
+bool commandMerge(Command& cmd, const Command& next) {
+    if (cmd.type != next.type) return false;
+    switch (cmd.type) {
+        case CMD_PLAY:    if (next.arg < 0) return false;  // A toggle depends on what's before it
+                          cmd.arg = next.arg; return true; // Last requested state wins
+        case CMD_VOLUME:                                  // Just a nudge, target lives in volumeCtl
+        case CMD_LIKE:
+        case CMD_REFRESH: return true;
+        default:          return false;
+    }
+}
+
+// ============================================================
+// === METRICS ===
+// ============================================================
+static const char* const metricNames[M_COUNT] = {
+    "http.player", "http.next", "http.prev", "http.play", "http.pause", "http.seek",
+    "http.volume", "http.like", "http.queue", "http.other", "http.token", "http.art",
+    "tls.new_session", "display.update", "art.flash", "art.cdn", "art.blit",
+    "poll.ok", "poll.fail", "http.error", "http.rate_limited",
+    "frame.count", "frame.rects", "frame.pushed_bytes", "frame.drawn_bytes", "glyph.hits", "glyph.misses",
+    "art.hits", "art.misses", "art.evictions", "art.flash_hits", "art.flash_misses", "art.flash_evicted",
+    "heap.free", "heap.min", "psram.free", "psram.min", "stack.spotify_free", "stack.art_free",
+};
+
+// Bucket i > 0 holds [ (4 + sub) << (oct - 2), (5 + sub) << (oct - 2) ) us,
+// with oct = 4 + (i - 1) / 4 and sub = (i - 1) % 4; bucket 0 is under 16 us
+int metricBucket(uint32_t us) {
+    if (us < 16) return 0;
+    int oct = 31 - __builtin_clz(us);
+    int sub = (us >> (oct - 2)) & 3;
+    return std::min((oct - 4) * 4 + sub + 1, METRIC_BUCKETS - 1);
+}
+
+uint32_t metricBucketTop(int i) {
+    if (i == 0) return 16;
+    int oct = 4 + (i - 1) / 4, sub = (i - 1) % 4;
+    return (uint32_t)(5 + sub) << (oct - 2);
+}
+
+void metricAdd(MetricId id, uint32_t n) {
+    if (!metricsMutex) return;
+    xSemaphoreTake(metricsMutex, portMAX_DELAY);
+    metrics[id].sum += n;
+    metrics[id].count++;
+    xSemaphoreGive(metricsMutex);
+}
+
+void metricCount(MetricId id) {
+    metricAdd(id, 1);
+}
+
+void metricSet(MetricId id, int32_t value) {
+    if (!metricsMutex) return;
+    xSemaphoreTake(metricsMutex, portMAX_DELAY);
+    Metric& m = metrics[id];
+    if (m.count == 0 || value < m.low) m.low = value;
+    if (m.count == 0 || value > m.high) m.high = value;
+    m.value = value;
+    m.count++;
+    xSemaphoreGive(metricsMutex);
+}
+
+void metricObserve(MetricId id, uint32_t us) {
+    if (!metricsMutex) return;
+    xSemaphoreTake(metricsMutex, portMAX_DELAY);
+    Metric& m = metrics[id];
+    if (m.count == 0 || (int32_t)us < m.low) m.low = (int32_t)us;
+    if (m.count == 0 || (int32_t)us > m.high) m.high = (int32_t)us;
+    m.sum += us;
+    m.count++;
+    metricBuckets[id][metricBucket(us)]++;
+    xSemaphoreGive(metricsMutex);
+}
+
+// Heap, PSRAM and task stacks. ESP-IDF reports stack high-water marks in
+// bytes. Sampled after every poll and before a dump.
+void metricsSample() {
+    metricSet(M_HEAP_FREE, ESP.getFreeHeap());
+    metricSet(M_HEAP_MIN, ESP.getMinFreeHeap());
+    if (psramFound()) {
+        metricSet(M_PSRAM_FREE, ESP.getFreePsram());
+        metricSet(M_PSRAM_MIN, ESP.getMinFreePsram());
+    }
+    if (spotifyTaskHandle) metricSet(M_STACK_SPOTIFY, uxTaskGetStackHighWaterMark(spotifyTaskHandle));
+#ifdef ENABLE_ALBUM_ART
+    if (artTaskHandle) metricSet(M_STACK_ART, uxTaskGetStackHighWaterMark(artTaskHandle));
+#endif
+}
+
+// Upper bound of the bucket holding the pct-th percentile, capped at the max
+float metricPercentile(const uint32_t* buckets, const Metric& m, int pct) {
+    uint32_t rank = (m.count * pct + 99) / 100;
+    uint32_t seen = 0;
+    int i = 0;
+    for (; i < METRIC_BUCKETS - 1; i++) {
+        seen += buckets[i];
+        if (seen >= rank) break;
+    }
+    return std::min(metricBucketTop(i), (uint32_t)m.high) / 1000.0f;
+}
+
+// "stats" console command. Copies the registry out first so the other tasks
+// never wait on serial output.
+void metricsDump() {
+    static Metric snap[M_COUNT];                          // Loop only
+    static uint32_t snapBuckets[M_HISTOGRAMS][METRIC_BUCKETS];
+    metricsSample();
+    xSemaphoreTake(metricsMutex, portMAX_DELAY);
+    memcpy(snap, metrics, sizeof(snap));
+    memcpy(snapBuckets, metricBuckets, sizeof(snapBuckets));
+    unsigned long window = millis() - metricsSince;
+    xSemaphoreGive(metricsMutex);
+
+    Serial.printf("Stats over %lu s (request times on a reused session; tls.new_session includes the handshake):\n",
+                  window / 1000);
+    for (int id = 0; id < M_COUNT; id++) {
+        const Metric& m = snap[id];
+        if (id < M_HISTOGRAMS) {
+            if (m.count == 0) continue;
+            Serial.printf("  %-18s n=%-5lu p50=%.1f p95=%.1f p99=%.1f max=%.1f ms\n", metricNames[id],
+                          (unsigned long)m.count, metricPercentile(snapBuckets[id], m, 50),
+                          metricPercentile(snapBuckets[id], m, 95), metricPercentile(snapBuckets[id], m, 99),
+                          m.high / 1000.0f);
+        } else if (id == M_FRAME_PUSHED && snap[M_FRAME_DRAWN].sum > 0) {
+            Serial.printf("  %-18s %llu (%.0f%% of redrawing whole)\n", metricNames[id],
+                          (unsigned long long)m.sum, 100.0 * m.sum / snap[M_FRAME_DRAWN].sum);
+        } else if (id < M_GAUGES) {
+            Serial.printf("  %-18s %llu\n", metricNames[id], (unsigned long long)m.sum);
+        } else if (m.count > 0) {
+            Serial.printf("  %-18s %ld B (low %ld, high %ld)\n", metricNames[id], (long)m.value, (long)m.low,
+                          (long)m.high);
+        }
+    }
+}
+
+// "reset" console command: a fresh window for every metric (and the latency
+// windows); gauges start again from their next sample
+void metricsReset() {
+    xSemaphoreTake(metricsMutex, portMAX_DELAY);
+    memset(metrics, 0, sizeof(metrics));
+    memset(metricBuckets, 0, sizeof(metricBuckets));
+    metricsSince = millis();
+    xSemaphoreGive(metricsMutex);
+    xSemaphoreTake(latencyMutex, portMAX_DELAY);
+    memset(latencyWindows, 0, sizeof(latencyWindows));
+    xSemaphoreGive(latencyMutex);
+    Serial.println("Stats: reset");
+}
+
+// ============================================================
+// === LATENCY TRACING ===
+// ============================================================
+// Stages, all measured from the button callback:
+//   drawn     - first frame after the press (the optimistic state)
+//   sent      - request handed to HTTPClient (a new session's handshake counts
+//               towards the response)
+//   response  - status line back from Spotify
+//   confirmed - first frame after a poll shows the command took effect (or
+//               its optimistic state timed out and rolled back)
+static const char* const latencyNames[LATENCY_COMMANDS] = { "next", "prev", "play", "volume", "like" };
+static const char* const latencyStageNames[LAT_STAGES] = { "drawn", "sent", "response", "confirmed" };
+
+// Opens a trace for a press; REFRESH isn't user input. Reuses the oldest
+// slot if every one is still in flight.
+int8_t latencyBegin(CommandType type, uint32_t pressedUs) {
+    if (type >= LATENCY_COMMANDS || !latencyMutex) return -1;
+    xSemaphoreTake(latencyMutex, portMAX_DELAY);
+    int slot = 0;
+    for (int i = 0; i < LATENCY_TRACES; i++) {
+        if (!latencyTraces[i].active) { slot = i; break; }
+        if ((int32_t)(latencyTraces[i].pressUs - latencyTraces[slot].pressUs) < 0) slot = i;
+    }
+    LatencyTrace& t = latencyTraces[slot];
+    t = {};
+    t.active = true;
+    t.type = type;
+    t.pressUs = pressedUs;
+    xSemaphoreGive(latencyMutex);
+    return (int8_t)slot;
+}
+
+void latencyDrop(int8_t trace) {
+    if (trace < 0) return;
+    xSemaphoreTake(latencyMutex, portMAX_DELAY);
+    latencyTraces[trace].active = false;
+    xSemaphoreGive(latencyMutex);
+}
+
+// The command's request finished (spotifyTask), with its RequestTiming.
+// Nothing sent (no WiFi, nothing to like) means there is nothing to time.
+void latencyAnswered(int8_t trace, uint32_t sentUs, uint32_t responseUs) {
+    if (trace < 0) return;
+    xSemaphoreTake(latencyMutex, portMAX_DELAY);
+    LatencyTrace& t = latencyTraces[trace];
+    if (t.active && sentUs == 0) t.active = false;
+    if (t.active) {
+        t.stageUs[LAT_SENT] = sentUs;
+        t.stageUs[LAT_RESPONSE] = responseUs;
+        t.answered = true;
+    }
+    xSemaphoreGive(latencyMutex);
+}
+
+// A poll landed (spotifyTask, caller holds dataMutex): answered commands whose
+// optimistic state has been settled are confirmed
+void latencyPolled() {
+    xSemaphoreTake(latencyMutex, portMAX_DELAY);
+    for (LatencyTrace& t : latencyTraces) {
+        if (!t.active || !t.answered || t.confirmed) continue;
+        switch (t.type) {
+            case CMD_NEXT:
+            case CMD_PREV:   t.confirmed = pending.skip == 0 && !pending.restart; break;
+            case CMD_PLAY:   t.confirmed = !pending.play; break;
+            case CMD_VOLUME: t.confirmed = volumeCtl.target < 0; break;
+            default:         t.confirmed = true; break; // Liked state isn't polled
+        }
+    }
+    xSemaphoreGive(latencyMutex);
+}
+
+void latencyRecord(LatencyWindow& w, uint32_t us) {
+    w.samples[w.next] = us;
+    w.next = (w.next + 1) % LATENCY_WINDOW;
+    if (w.count < LATENCY_WINDOW) w.count++;
+}
+
+// End of updateDisplay() (loop only): stamps the first frame of new presses
+// and closes confirmed traces into the windows
+void latencyFrameDone() {
+    uint32_t now = micros();
+    xSemaphoreTake(latencyMutex, portMAX_DELAY);
+    for (LatencyTrace& t : latencyTraces) {
+        if (!t.active) continue;
+        if (t.stageUs[LAT_DRAWN] == 0) t.stageUs[LAT_DRAWN] = now;
+        if (!t.confirmed) continue;
+        t.stageUs[LAT_CONFIRMED] = now;
+        t.active = false;
+        uint32_t ms[LAT_STAGES];
+        for (int s = 0; s < LAT_STAGES; s++) {
+            uint32_t us = t.stageUs[s] - t.pressUs;
+            latencyRecord(latencyWindows[t.type][s], us);
+            ms[s] = us / 1000;
+        }
+        Serial.printf("Latency: %s drawn %lu ms, sent %lu ms, response %lu ms, confirmed %lu ms\n",
+                      latencyNames[t.type], (unsigned long)ms[LAT_DRAWN], (unsigned long)ms[LAT_SENT],
+                      (unsigned long)ms[LAT_RESPONSE], (unsigned long)ms[LAT_CONFIRMED]);
+    }
+    xSemaphoreGive(latencyMutex);
+}
+
+// Nearest-rank percentile of a sorted window, in milliseconds
+float latencyPercentile(const uint32_t* sorted, int n, int pct) {
+    int rank = (n * pct + 99) / 100;
+    return sorted[std::max(rank, 1) - 1] / 1000.0f;
+}
+
+// "latency" console command: p50/p95/p99 per command and stage
+void latencyDump() {
+    static uint32_t sorted[LATENCY_WINDOW]; // Loop only
+    Serial.printf("Latency from press, ms (p50/p95/p99 over the last %d presses):\n", LATENCY_WINDOW);
+    for (int c = 0; c < LATENCY_COMMANDS; c++) {
+        char line[192];
+        int len = 0;
+        int n = 0;
+        for (int s = 0; s < LAT_STAGES; s++) {
+            xSemaphoreTake(latencyMutex, portMAX_DELAY);
+            const LatencyWindow& w = latencyWindows[c][s];
+            n = w.count;
+            memcpy(sorted, w.samples, n * sizeof(uint32_t));
+            xSemaphoreGive(latencyMutex);
+            if (n == 0) break;
+            std::sort(sorted, sorted + n);
+            len += snprintf(line + len, sizeof(line) - len, "  %s %.1f/%.1f/%.1f", latencyStageNames[s],
+                            latencyPercentile(sorted, n, 50), latencyPercentile(sorted, n, 95),
+                            latencyPercentile(sorted, n, 99));
+        }
+        if (n == 0) Serial.printf("  %-6s n=0\n", latencyNames[c]);
+        else Serial.printf("  %-6s n=%d%s\n", latencyNames[c], n, line);
+    }
+}
+
+// ============================================================
+// === SERIAL CONSOLE ===
+// ============================================================
+// One command per line at monitor_speed. Input wakes loop() (UI_WAKE_SERIAL)
+// and is handled between frames, so the UI never waits on the console.
+void consoleRun(const char* line) {
+    if (strcmp(line, "latency") == 0) latencyDump();
+    else if (strcmp(line, "stats") == 0) metricsDump();
+    else if (strcmp(line, "reset") == 0) metricsReset();
+    else Serial.printf("Console: unknown command '%s' (try: stats, latency, reset)\n", line);
+}
+
+void consolePoll() {
+    static char line[64];
+    static size_t len = 0;
+    while (Serial.available() > 0) {
+        int c = Serial.read();
+        if (c == '\r' || c == '\n') {
+            line[len] = '\0';
+            if (len > 0) consoleRun(line);
+            len = 0;
+        } else if (len + 1 < sizeof(line)) {
+            line[len++] = (char)c;
+        }
+    }
+}
+
+// ============================================================
+// === API CONNECTION (KEEP-ALIVE) ===
+// ============================================================
+// Long-lived TLS sessions. Every foreground Web API call (poll, commands,
+// volume, like) shares apiConn, so we only pay the handshake when the server
+// drops the socket instead of once per request. ArtTask's queue prefetch has
+// its own (queueConn) so it never sits in front of a command.
+
+// Response body reader. HTTP/1.1 keep-alive means bodies may arrive chunked,
+// so this de-chunks on the fly (ArduinoJson can then parse straight off the
+// socket) and knows where the body ends so the socket can be reused.
+class ApiBodyStream : public Stream {
+public:
+    void begin(Stream* src, int contentLength, bool chunked) {
+        _src = src;
+        _chunked = chunked;
+        _started = false;
+        _left = chunked ? 0 : contentLength; // -1 = no length, read until close
+        _done = (src == NULL) || (!chunked && contentLength == 0);
+    }
+
+    int available() override {
+        if (_done || !_src) return 0;
+        int avail = _src->available();
+        if (_left > 0 && avail > _left) avail = _left;
+        return avail;
+    }
+
+    int read() override {
+        if (!prepare()) return -1;
+        int c = _src->read();
+        if (c >= 0) consumed(1);
+        return c;
+    }
+
+    int peek() override {
+        if (!prepare()) return -1;
+        return _src->peek();
+    }
+
+    // Bulk read, bounded by the current chunk / remaining length
+    size_t readBytes(char* buffer, size_t length) override {
+        size_t count = 0;
+        while (count < length && prepare()) {
+            size_t want = length - count;
+            if (_left > 0 && (size_t)_left < want) want = _left;
+            size_t n = _src->readBytes(buffer + count, want);
+            if (n == 0) break;
+            consumed(n);
+            count += n;
+        }
+        return count;
+    }
+    using Stream::readBytes;
+
+    size_t write(uint8_t) override { return 0; }
+
+    // Consume whatever the caller didn't read. Returns false if the body has
+    // no known end (or timed out), in which case the socket can't be reused.
+    bool drain() {
+        if (!_chunked && _left < 0) return _done;
+        uint8_t scratch[64];
+        while (prepare()) {
+            size_t want = (_left > 0 && _left < (int)sizeof(scratch)) ? _left : sizeof(scratch);
+            size_t n = _src->readBytes(scratch, want);
+            if (n == 0) return false;
+            consumed(n);
+        }
+        return _done;
+    }
+
+private:
+    Stream* _src = NULL;
+    int _left = 0;
+    bool _chunked = false;
+    bool _started = false;
+    bool _done = true;
+
+    int blockingRead() {
+        char c;
+        return _src->readBytes(&c, 1) == 1 ? (uint8_t)c : -1;
+    }
+
+    void skipLine() {
+        int c;
+        while ((c = blockingRead()) >= 0 && c != '\n') {}
+    }
+
+    void consumed(int n) {
+        if (_left > 0) _left -= n;
+        if (!_chunked && _left == 0) _done = true;
+    }
+
+    // At a chunk boundary, read the next "<hex-size>[;ext]\r\n" header
+    bool prepare() {
+        if (_done || !_src) return false;
+        if (!_chunked || _left > 0) return true;
+
+        if (_started) skipLine(); // CRLF closing the previous chunk
+        _started = true;
+
+        long size = 0;
+        bool inSize = true;
+        int c;
+        while ((c = blockingRead()) >= 0 && c != '\n') {
+            if (!inSize) continue;
+            if (c >= '0' && c <= '9') size = size * 16 + (c - '0');
+            else if (c >= 'a' && c <= 'f') size = size * 16 + (c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') size = size * 16 + (c - 'A' + 10);
+            else inSize = false; // ';' extension or '\r'
+        }
+        if (c >= 0 && size == 0) skipLine(); // Final CRLF after last-chunk (no trailers)
+        if (c < 0 || size <= 0) {
+            _done = true;
+            return false;
+        }
+        _left = size;
+        return true;
+    }
+};
+
+struct ApiConnection {
+    const char* name;
     WiFiClientSecure client;
-    client.setInsecure(); 
-    client.setHandshakeTimeout(30); 
     HTTPClient http;
+    ApiBodyStream body;
+    SemaphoreHandle_t lock = NULL;
+    char host[64] = "";
+    bool bodyOpened = false;
+    // Stats (confirm reuse: handshakes should stay far below requests)
+    uint32_t handshakes = 0;
+    uint32_t requests = 0;
+    uint32_t reconnects = 0;
+    uint32_t rateLimited = 0;
+    unsigned long retryAt = 0;      // Set by a 429: hold polls until then (0 = none)
+    MetricId hostMetric;            // Request-time histogram for this host...
+    MetricId endpoint;              // ...or for the request being made (api.spotify.com)
+
+    ApiConnection(const char* n, MetricId m) : name(n), hostMetric(m), endpoint(m) {}
+};
+
+ApiConnection apiConn("api", M_HTTP_OTHER);   // api.spotify.com
+ApiConnection authConn("auth", M_HTTP_TOKEN); // Token relay (authurl)
+
+// Web API paths with their own request-time histogram
+struct ApiEndpoint {
+    const char* const* url;
+    MetricId metric;
+};
+const ApiEndpoint apiEndpoints[] = {
+    { &SPOT_PLAYER, M_HTTP_PLAYER }, { &SPOT_NEXT, M_HTTP_NEXT },     { &SPOT_PREV, M_HTTP_PREV },
+    { &SPOT_PLAY, M_HTTP_PLAY },     { &SPOT_PAUSE, M_HTTP_PAUSE },   { &SPOT_SEEK, M_HTTP_SEEK },
+    { &SPOT_VOLUME, M_HTTP_VOLUME }, { &SPOT_LIB, M_HTTP_LIKE },      { &SPOT_QUEUE, M_HTTP_QUEUE },
+};
+
+MetricId apiEndpointMetric(const ApiConnection& conn, const char* url) {
+    if (conn.hostMetric != M_HTTP_OTHER) return conn.hostMetric;
+    size_t pathLen = strcspn(url, "?");
+    for (const ApiEndpoint& e : apiEndpoints) {
+        if (strlen(*e.url) == pathLen && strncmp(url, *e.url, pathLen) == 0) return e.metric;
+    }
+    return M_HTTP_OTHER;
+}
+
+void apiInitConnection(ApiConnection& conn) {
+    conn.lock = xSemaphoreCreateMutex();
+    conn.client.setInsecure();
+    conn.client.setHandshakeTimeout(30);
+    conn.http.setReuse(true);
+    conn.http.useHTTP10(false);
+    static const char* keys[] = { "Transfer-Encoding", "Retry-After" };
+    conn.http.collectHeaders(keys, 2);
+}
+
+void apiInit() {
+    apiInitConnection(apiConn);
+    apiInitConnection(authConn);
+}
+
+// Takes the connection and points it at url. Must be paired with apiEnd().
+bool apiBegin(ApiConnection& conn, const char* url) {
+    xSemaphoreTake(conn.lock, portMAX_DELAY);
+
+    // A live socket is bound to its host; never send a request down the wrong one
+    const char* h = strstr(url, "://");
+    h = h ? h + 3 : url;
+    size_t hostLen = strcspn(h, "/:?");
+    if (hostLen != strlen(conn.host) || strncmp(h, conn.host, hostLen) != 0) {
+        conn.client.stop();
+        snprintf(conn.host, sizeof(conn.host), "%.*s", (int)hostLen, h);
+    }
+
+    conn.bodyOpened = false;
+    conn.endpoint = apiEndpointMetric(conn, url);
+    if (!conn.http.begin(conn.client, url)) {
+        xSemaphoreGive(conn.lock);
+        return false;
+    }
+    return true;
+}
+
+// Latency tracing out-param: micros() of the first send and the last response
+// (retries keep the first send; sentUs stays 0 if nothing went out)
+struct RequestTiming {
+    uint32_t sentUs = 0;
+    uint32_t responseUs = 0;
+};
+
+// Sends the prepared request. If a reused socket turns out to be dead (server
+// idle timeout), reconnects and retries once.
+int apiSend(ApiConnection& conn, const char* method, RequestTiming* timing = NULL) {
+    int code = 0;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        bool reused = conn.client.connected();
+        if (!reused) {
+            conn.handshakes++;
+            Serial.printf("API[%s]: New TLS session to %s (handshakes=%lu, requests=%lu)\n",
+                          conn.name, conn.host, (unsigned long)conn.handshakes, (unsigned long)conn.requests);
+        }
+        conn.requests++;
+        uint32_t start = micros();
+        code = conn.http.sendRequest(method, (uint8_t*)NULL, 0);
+        uint32_t end = micros();
+        if (timing) {
+            if (timing->sentUs == 0) timing->sentUs = start;
+            timing->responseUs = end;
+        }
+        // HTTPClient connects inside sendRequest, so a new session's request
+        // time is the handshake plus one exchange
+        metricObserve(reused ? conn.endpoint : M_TLS_SESSION, end - start);
+        if (code <= 0) metricCount(M_HTTP_ERROR);
+        if (code > 0 || !reused) break;
+
+        conn.reconnects++;
+        conn.client.stop();
+    }
+    if (code == 429) {
+        long secs = conn.http.header("Retry-After").toInt();
+        if (secs <= 0) secs = 1;
+        conn.rateLimited++;
+        metricCount(M_HTTP_RATE_LIMITED);
+        conn.retryAt = millis() + secs * 1000;
+        if (conn.retryAt == 0) conn.retryAt = 1;
+        Serial.printf("API[%s]: 429, backing off %ld s\n", conn.name, secs);
+    }
+    return code;
+}
+
+// Response body for the current request, de-chunked and length-bounded
+Stream& apiBody(ApiConnection& conn) {
+    if (!conn.bodyOpened) {
+        int len = conn.http.getSize();
+        bool chunked = (len < 0) && conn.http.header("Transfer-Encoding").equalsIgnoreCase("chunked");
+        conn.body.begin(conn.http.getStreamPtr(), len, chunked);
+        conn.bodyOpened = true;
+    }
+    return conn.body;
+}
+
+// Finishes the request. The socket stays open for the next call unless the
+// body could not be consumed cleanly.
+void apiEnd(ApiConnection& conn) {
+    if (conn.http.connected()) {
+        apiBody(conn);
+        if (!conn.body.drain()) conn.client.stop();
+    }
+    conn.http.end();
+    xSemaphoreGive(conn.lock);
+}
+
+// Fixed-buffer URL builder for Web API calls, so command paths never touch
+// the heap. Values are percent-encoded; ok() is false if the URL didn't fit.
+struct RequestUrl {
+    char buf[256];
+    size_t len = 0;
+    bool overflow = false;
+
+    RequestUrl(const char* base) {
+        buf[0] = '\0';
+        append(base);
+    }
+
+    RequestUrl& append(const char* s) {
+        while (*s) put(*s++);
+        return *this;
+    }
+
+    RequestUrl& param(const char* key, const char* value) {
+        put(strchr(buf, '?') ? '&' : '?');
+        append(key);
+        put('=');
+        static const char hex[] = "0123456789ABCDEF";
+        for (const uint8_t* p = (const uint8_t*)value; *p; p++) {
+            if (isalnum(*p) || *p == '-' || *p == '_' || *p == '.' || *p == '~') {
+                put(*p);
+            } else {
+                put('%');
+                put(hex[*p >> 4]);
+                put(hex[*p & 0x0F]);
+            }
+        }
+        return *this;
+    }
+
+    RequestUrl& param(const char* key, long value) {
+        char num[12];
+        snprintf(num, sizeof(num), "%ld", value);
+        return param(key, num);
+    }
+
+    bool ok() const { return !overflow; }
+    const char* c_str() const { return buf; }
+
+private:
+    void put(char c) {
+        if (len + 1 >= sizeof(buf)) {
+            overflow = true;
+            return;
+        }
+        buf[len++] = c;
+        buf[len] = '\0';
+    }
+};
+
+// ============================================================
+// === API IMPLEMENTATION ===
+// ============================================================
+
+boolean refreshAccessToken(char *targetBuffer, const char* baseurl) {
     JsonDocument jsonDoc;
     strlcpy(urlbuffer, authurl, sizeof(urlbuffer));
     strlcat(urlbuffer, "refresh?deviceId=", sizeof(urlbuffer));
@@ -565,57 +2262,211 @@ boolean refreshAccessToken(char *targetBuffer, const char* baseurl) {
     // Serial.printf("Polling Auth: %s\n", urlbuffer); 
     Serial.printf("Polling Device ID: %s\n", deviceId);
 
-    if (!http.begin(client, urlbuffer)) return false;
+    if (!apiBegin(authConn, urlbuffer)) return false;
     
-    int httpResponseCode = http.GET();
+    int httpResponseCode = apiSend(authConn, "GET");
     boolean result = false;
     if (httpResponseCode == 200) {   
-        DeserializationError error = deserializeJson(jsonDoc, http.getStream());
+        DeserializationError error = deserializeJson(jsonDoc, apiBody(authConn));
         if (!error) {
              const char *newToken = jsonDoc["access_token"];
              if (newToken) {
+                xSemaphoreTake(tokenMutex, portMAX_DELAY);
                 strlcpy(targetBuffer, newToken, 512); 
+                snprintf(bearerAuth, sizeof(bearerAuth), "Bearer %s", newToken);
+                tokenGeneration++;
+                xSemaphoreGive(tokenMutex);
+
+                // Schedule the next renewal ahead of expiry (short-lived
+                // tokens renew at half-life)
+                unsigned long lifetime = (unsigned long)(jsonDoc["expires_in"] | 0) * 1000UL;
+                if (lifetime == 0) tokenRenewAt = 0;
+                else {
+                    unsigned long renewIn = (lifetime > 2 * TOKEN_RENEW_MARGIN_MS) ? lifetime - TOKEN_RENEW_MARGIN_MS
+                                                                                   : lifetime / 2;
+                    tokenRenewAt = millis() + renewIn;
+                    if (tokenRenewAt == 0) tokenRenewAt = 1;
+                }
+                Serial.printf("Token: new (expires in %lu s)\n", lifetime / 1000);
                 result = true;
              }
         }
     }
-    http.end();
-    return result;
-}
+    apiEnd(authConn);
+    return result;
+}
+
+// Single-flight renewal. Callers pass the generation of the token that was
+// rejected (or is about to expire): the first one in refreshes, and anyone
+// queued behind it finds the generation already moved on and just reuses the
+// new token.
+bool renewAccessToken(uint32_t staleGeneration) {
+    xSemaphoreTake(tokenRefreshMutex, portMAX_DELAY);
+    bool ok = true;
+    if (tokenGeneration == staleGeneration) ok = refreshAccessToken(accesstoken, authurl);
+    xSemaphoreGive(tokenRefreshMutex);
+    return ok;
+}
+
+// Adds the cached bearer header to the prepared request; returns the
+// generation of the token it carries (for renewAccessToken)
+uint32_t apiAuthorize(ApiConnection& conn) {
+    xSemaphoreTake(tokenMutex, portMAX_DELAY);
+    conn.http.addHeader("Authorization", bearerAuth);
+    uint32_t gen = tokenGeneration;
+    xSemaphoreGive(tokenMutex);
+    return gen;
+}
+
+// Authorized request with an empty body on the shared Web API connection.
+// A 401 renews the token (single-flight) and retries once.
+int spotifyRequest(const char* method, const char* url, RequestTiming* timing) {
+    int httpCode = -1;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (!apiBegin(apiConn, url)) return -1;
+        uint32_t gen = apiAuthorize(apiConn);
+        if (strcmp(method, "GET") != 0) apiConn.http.addHeader("Content-Length", "0");
+        httpCode = apiSend(apiConn, method, timing);
+        apiEnd(apiConn);
+        if (httpCode != 401 || !renewAccessToken(gen)) break;
+    }
+    return httpCode;
+}
+
+// Cover variant for the art pane: the smallest one at least ART_PANE_SIZE
+// wide (fewest bytes to fetch and decode), else the largest on offer
+const char* pickAlbumImage(JsonArray images) {
+    const char* best = NULL;
+    int bestWidth = 0;
+    for (JsonObject image : images) {
+        const char* url = image["url"];
+        if (!url) continue;
+        int width = image["width"] | 0;
+        bool fits = width >= ART_PANE_SIZE;
+        bool bestFits = bestWidth >= ART_PANE_SIZE;
+        if (!best || (fits && (!bestFits || width < bestWidth)) || (!fits && !bestFits && width > bestWidth)) {
+            best = url;
+            bestWidth = width;
+        }
+    }
+    return best;
+}
+
+// ============================================================
+// === PLAYER STATE PARSER ===
+// ============================================================
+// Bump allocator for ArduinoJson. The player-state document is parsed into it
+// and it is reset before the next poll, so steady-state polling never touches
+// the heap. Whatever doesn't fit falls back to the heap and is counted:
+// heapAllocs should stay at 0 (raise JSON_ARENA_SIZE if it doesn't).
+class JsonArena : public ArduinoJson::Allocator {
+public:
+    uint32_t allocs = 0;         // This parse
+    uint32_t heapAllocs = 0;     // This parse, served by the heap fallback
+    size_t peak = 0;             // Bytes, since boot
+
+    bool begin(size_t size) {
+        _buf = (uint8_t*)heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!_buf) _buf = (uint8_t*)heap_caps_malloc(size, MALLOC_CAP_8BIT);
+        _size = _buf ? size : 0;
+        return _buf != NULL;
+    }
+
+    // Only once no document points into the arena any more
+    void reset() {
+        _used = 0;
+        allocs = 0;
+        heapAllocs = 0;
+    }
+
+    void* allocate(size_t size) override {
+        allocs++;
+        size_t need = HEADER + align(size);
+        if (_buf && _used + need <= _size) {
+            uint8_t* p = _buf + _used;
+            *(size_t*)p = size;
+            take(need);
+            return p + HEADER;
+        }
+        heapAllocs++;
+        return malloc(size);
+    }
+
+    void deallocate(void* ptr) override {
+        if (!owns(ptr)) free(ptr); // Arena blocks all go at reset()
+    }
+
+    void* reallocate(void* ptr, size_t newSize) override {
+        if (!ptr) return allocate(newSize);
+        if (!owns(ptr)) return realloc(ptr, newSize);
+        uint8_t* p = (uint8_t*)ptr;
+        size_t& oldSize = *(size_t*)(p - HEADER);
+        if (p + align(oldSize) == _buf + _used) {
+            // Newest block (the usual case: a pool or string being trimmed)
+            size_t end = (p - _buf) + align(newSize);
+            if (end <= _size) {
+                if (end < _used) _used = end;
+                else take(end - _used);
+                oldSize = newSize;
+                return ptr;
+            }
+        } else if (newSize <= oldSize) {
+            oldSize = newSize;
+            return ptr;
+        }
+        void* moved = allocate(newSize);
+        if (moved) memcpy(moved, ptr, oldSize);
+        return moved;
+    }
 
-boolean getSpotifyData() {
-    if (WiFi.status() != WL_CONNECTED) return false;
-    WiFiClientSecure client;
-    client.setInsecure();
-    client.setHandshakeTimeout(30);
-    HTTPClient http;
-    http.useHTTP10(true);
+private:
+    static const size_t HEADER = 8; // Block size, keeps payloads 8-byte aligned
+    uint8_t* _buf = NULL;
+    size_t _size = 0;
+    size_t _used = 0;
+
+    static size_t align(size_t n) { return (n + 7) & ~(size_t)7; }
+    bool owns(void* p) const { return _buf && (uint8_t*)p >= _buf && (uint8_t*)p < _buf + _size; }
+    void take(size_t n) {
+        _used += n;
+        if (_used > peak) peak = _used;
+    }
+};
+
+JsonArena playerArena;        // spotifyTask only
+JsonDocument playerFilter;    // Fields of /me/player we keep; built once in setup
+
+void buildPlayerFilter() {
+    playerFilter["device"]["name"] = true;
+    playerFilter["device"]["id"] = true;
+    playerFilter["device"]["volume_percent"] = true;
+    playerFilter["is_playing"] = true;
+    playerFilter["progress_ms"] = true;
+    playerFilter["item"]["name"] = true;
+    playerFilter["item"]["album"]["name"] = true;
+    playerFilter["item"]["id"] = true;
+    playerFilter["item"]["album"]["images"] = true; 
+    playerFilter["item"]["artists"][0]["name"] = true;
+    playerFilter["item"]["duration_ms"] = true;
+}
 
-    if (!http.begin(client, SPOT_PLAYER)) return false;
+// Polls the player state. Returns the HTTP code (<= 0 on connection failure);
+// *changed says whether the response differed from what we already showed.
+int getSpotifyData(bool* changed) {
+    *changed = false;
+    if (WiFi.status() != WL_CONNECTED) return -1;
+    if (!apiBegin(apiConn, SPOT_PLAYER)) return -1;
     
-    char auth[512];
-    snprintf(auth, sizeof(auth), "Bearer %s", accesstoken);
-    http.addHeader("Authorization", auth);
+    uint32_t tokenGen = apiAuthorize(apiConn);
 
-    int httpCode = http.GET();
+    int httpCode = apiSend(apiConn, "GET");
+    unsigned long arrivedAt = millis(); // Anchor for progress_ms (no synced clock for "timestamp")
     
     if (httpCode == 200) {
-        Stream& responseStream = http.getStream();
-        JsonDocument filter;
-        filter["device"]["name"] = true;
-        filter["device"]["id"] = true;
-        filter["device"]["volume_percent"] = true;
-        filter["is_playing"] = true;
-        filter["progress_ms"] = true;
-        filter["item"]["name"] = true;
-        filter["item"]["album"]["name"] = true;
-        filter["item"]["id"] = true;
-        filter["item"]["album"]["images"] = true; 
-        filter["item"]["artists"][0]["name"] = true;
-        filter["item"]["duration_ms"] = true;
-
-        JsonDocument doc;
-        DeserializationError error = deserializeJson(doc, responseStream, DeserializationOption::Filter(filter));
+        Stream& responseStream = apiBody(apiConn);
+        playerArena.reset(); // Last poll's document is gone
+        JsonDocument doc(&playerArena);
+        DeserializationError error = deserializeJson(doc, responseStream, DeserializationOption::Filter(playerFilter));
 
         if (!error) {
             const char* spDevId = doc["device"]["id"];
@@ -632,6 +2483,12 @@ boolean getSpotifyData() {
                 const char* alName = doc["item"]["album"]["name"];
                 const char* dName = doc["device"]["name"];
                 const char* tId = doc["item"]["id"];
+                bool sameTrack = tId && strcmp(tId, sharedState.trackID) == 0;
+                bool playing = doc["is_playing"];
+                int volume = doc["device"]["volume_percent"];
+                bool skipPending = optimisticReconcile(tId, doc["progress_ms"], &playing, &volume);
+                *changed = !sameTrack || playing != sharedState.isPlaying || volume != sharedState.volumePercent ||
+                           (dName && strncmp(dName, sharedState.deviceName, 63) != 0);
                 
                 if (tName) strlcpy(sharedState.trackName, tName, 64);
                 if (aName) strlcpy(sharedState.artistName, aName, 64);
@@ -640,132 +2497,683 @@ boolean getSpotifyData() {
                 if (tId) strlcpy(sharedState.trackID, tId, 64);
 
                 // Image Logic
-                const char* imgUrl = NULL;
-                JsonArray images = doc["item"]["album"]["images"];
-                if (!images.isNull() && images.size() > 0) {
-                    if (images.size() > 1) imgUrl = images[1]["url"];
-                    else imgUrl = images[0]["url"];
-                }
+                const char* imgUrl = pickAlbumImage(doc["item"]["album"]["images"]);
                 if (imgUrl && strcmp(sharedState.imageUrl, imgUrl) != 0) {
                     strlcpy(sharedState.imageUrl, imgUrl, 256);
                 }
 
                 sharedState.progressMS = doc["progress_ms"];
                 sharedState.durationMS = doc["item"]["duration_ms"];
-                sharedState.isPlaying = doc["is_playing"];
-                sharedState.volumePercent = doc["device"]["volume_percent"];
+                sharedState.isPlaying = playing;
+                sharedState.volumePercent = volume;
+                if (!skipPending && playbackClockSync(sameTrack, sharedState.progressMS, sharedState.durationMS,
+                                                      sharedState.isPlaying, arrivedAt)) *changed = true;
                 
                 newDataAvailable = true;
                 xSemaphoreGive(dataMutex);
             }
-            http.end();
-            return true;
+        } else {
+            httpCode = -1;
         }
     } else if (httpCode == 204) {
         // No Active Device
         if (xSemaphoreTake(dataMutex, 100) == pdTRUE) {
+            *changed = strcmp(sharedState.trackName, "No Active Device") != 0;
             strlcpy(sharedState.trackName, "No Active Device", 64);
             strlcpy(sharedState.artistName, "Tap Play to Wake", 64);
-            sharedState.isPlaying = false;
+            bool playing = false;
+            int volume = sharedState.volumePercent;
+            optimisticReconcile(NULL, 0, &playing, &volume);
+            sharedState.isPlaying = playing;
+            playbackClockSetPlaying(playing);
             newDataAvailable = true;
             xSemaphoreGive(dataMutex);
         }
-    } else if (httpCode == 401) {
-        refreshAccessToken(accesstoken, authurl);
     }
-    http.end();
-    return false;
+    apiEnd(apiConn);
+
+    if (httpCode == 401) {
+        renewAccessToken(tokenGen);
+    }
+    return httpCode;
 }
 
-void setSpotifyVolume(int percent) {
-    WiFiClientSecure client;
-    client.setInsecure();
-    HTTPClient http;
-    char url[128];
-    snprintf(url, sizeof(url), "%s?volume_percent=%d", SPOT_VOLUME, percent);
-    http.begin(client, url);
-    char auth[512];
-    snprintf(auth, sizeof(auth), "Bearer %s", accesstoken);
-    http.addHeader("Authorization", auth);
-    http.addHeader("Content-Length", "0");
-    int code = http.PUT("");
-    if (code == 401) refreshAccessToken(accesstoken, authurl);
-    http.end();
-}
-
-void sendSpotifyCommand(const char* method, const char* endpoint) {
-    if (WiFi.status() != WL_CONNECTED) return;
-    WiFiClientSecure client;
-    client.setInsecure();
-    HTTPClient http;
-    String requestUrl = String(endpoint);
-    http.begin(client, requestUrl);
-    char auth[512];
-    snprintf(auth, sizeof(auth), "Bearer %s", accesstoken);
-    http.addHeader("Authorization", auth);
-    http.addHeader("Content-Length", "0");
+int setSpotifyVolume(int percent, RequestTiming* timing) {
+    RequestUrl url(SPOT_VOLUME);
+    url.param("volume_percent", (long)percent);
+    return spotifyRequest("PUT", url.c_str(), timing);
+}
+
+int sendSpotifyCommand(const char* method, const RequestUrl& url, RequestTiming* timing) {
+    if (WiFi.status() != WL_CONNECTED) return -1;
+    if (!url.ok()) {
+        Serial.printf("CMD: URL too long: %s\n", url.c_str());
+        return -1;
+    }
     
-    int httpCode = 0;
-    if (strcmp(method, "POST") == 0) httpCode = http.POST("");
-    else if (strcmp(method, "PUT") == 0) httpCode = http.PUT("");
+    int httpCode = spotifyRequest(method, url.c_str(), timing);
 
-    if (httpCode == 401) {
-        if (refreshAccessToken(accesstoken, authurl)) {
-            http.end(); 
-            http.begin(client, requestUrl);
-            snprintf(auth, sizeof(auth), "Bearer %s", accesstoken);
-            http.addHeader("Authorization", auth);
-            http.addHeader("Content-Length", "0");
-            if (strcmp(method, "POST") == 0) httpCode = http.POST("");
-            else if (strcmp(method, "PUT") == 0) httpCode = http.PUT("");
-        }
-    } else if ((httpCode == 404 || httpCode == 403) && strlen(g_lastSpotifyDeviceID) > 0) {
+    if ((httpCode == 404 || httpCode == 403) && strlen(g_lastSpotifyDeviceID) > 0) {
         // Retry with Device ID
-        if (requestUrl.indexOf('?') == -1) requestUrl += "?device_id=";
-        else requestUrl += "&device_id=";
-        requestUrl += String(g_lastSpotifyDeviceID);
-        http.end();
-        http.begin(client, requestUrl);
-        snprintf(auth, sizeof(auth), "Bearer %s", accesstoken);
-        http.addHeader("Authorization", auth);
-        http.addHeader("Content-Length", "0");
-        if (strcmp(method, "POST") == 0) httpCode = http.POST("");
-        else if (strcmp(method, "PUT") == 0) httpCode = http.PUT("");
-    }
-    http.end();
-}
-
-void saveToLiked() {
-    // 1. Check ID
-    char tid[64];
+        RequestUrl retry = url;
+        retry.param("device_id", g_lastSpotifyDeviceID);
+        if (retry.ok()) httpCode = spotifyRequest(method, retry.c_str(), timing);
+    }
+    return httpCode;
+}
+
+void saveToLiked(RequestTiming* timing) {
+    // 1. Check ID (the track on screen when the button was held)
+    char tid[64] = "";
     if (xSemaphoreTake(dataMutex, 100) == pdTRUE) {
-        strlcpy(tid, sharedState.trackID, 64);
+        strlcpy(tid, likedTrackID, 64);
         xSemaphoreGive(dataMutex);
     }
     
     if (strlen(tid) < 5) return; 
 
-    WiFiClientSecure client;
-    client.setInsecure();
-    HTTPClient http;
-    
     // PUT /v1/me/tracks?ids={id}
-    String url = String(SPOT_LIB) + "?ids=" + String(tid);
+    RequestUrl url(SPOT_LIB);
+    url.param("ids", tid);
     
-    http.begin(client, url);
-    char auth[512];
-    snprintf(auth, sizeof(auth), "Bearer %s", accesstoken);
-    http.addHeader("Authorization", auth);
-    http.addHeader("Content-Length", "0"); 
-    
-    int httpCode = http.PUT("");
+    int httpCode = spotifyRequest("PUT", url.c_str(), timing);
     if (httpCode == 200) {
         Serial.println("Saved to Liked Songs!");
     } else {
         Serial.printf("Save Error: %d\n", httpCode);
-        if (httpCode == 401) refreshAccessToken(accesstoken, authurl);
+        // Roll back the badge
+        if (xSemaphoreTake(dataMutex, 100) == pdTRUE) {
+            if (strcmp(likedTrackID, tid) == 0) likedTrackID[0] = '\0';
+            newDataAvailable = true;
+            xSemaphoreGive(dataMutex);
+            uiNotify(UI_WAKE_DATA);
+        }
+    }
+}
+
+// ============================================================
+// === ALBUM ART PIPELINE ===
+// ============================================================
+// Downloads and decodes run on ArtTask so a slow CDN never blocks buttons or
+// display updates. Each request carries a generation; when the track changes
+// mid-download the old request goes stale and is abandoned at the next check.
+
+ApiConnection artConn("art", M_HTTP_ART); // Image CDN (i.scdn.co), kept alive between covers
+// Prefetch's /me/player/queue reads (api.spotify.com). Its own session, so a
+// 20-track download never holds apiConn while a button press waits for it.
+ApiConnection queueConn("queue", M_HTTP_QUEUE);
+JsonDocument queueFilter;            // Fields of /me/player/queue we keep; built once in setup
+
+void buildQueueFilter() {
+    queueFilter["queue"][0]["album"]["images"] = true;
+}
+
+// Spotify image urls end in a unique id: use it as the cache key
+const char* artKey(const char* url) {
+    const char* slash = strrchr(url, '/');
+    return slash ? slash + 1 : url;
+}
+
+// Caller holds artMutex
+int artCacheFind(const char* key) {
+    for (int i = 0; i < artSlotCount; i++) {
+        if (artSlots[i].key[0] && strcmp(artSlots[i].key, key) == 0) {
+            artSlots[i].lastUsed = ++artUseClock;
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Caller holds artMutex. Empty slot first, else least recently used, but
+// never the slot still waiting to be blitted.
+int artCacheVictim() {
+    int victim = -1;
+    for (int i = 0; i < artSlotCount; i++) {
+        if (artSlotCount > 1 && artReady && i == artReadySlot) continue;
+        if (!artSlots[i].key[0]) return i;
+        if (victim < 0 || artSlots[i].lastUsed < artSlots[victim].lastUsed) victim = i;
+    }
+    return victim < 0 ? 0 : victim;
+}
+
+// Caller holds artMutex. Hand a slot to the loop for its next blit; the
+// caller wakes it with UI_WAKE_ART once the mutex is given back.
+void artPublish(int slot, uint32_t generation) {
+    artReadySlot = slot;
+    artReady = true;
+    artReadyGen = generation;
+}
+
+// A foreground request is stale once a newer one exists. A prefetch yields
+// as soon as a foreground request for some other cover is waiting.
+bool artStale(const ArtRequest& req) {
+    if (!req.prefetch) return req.generation != artWantedGen;
+    ArtRequest waiting;
+    if (xQueuePeek(artQueue, &waiting, 0) != pdTRUE) return false;
+    return strcmp(artKey(waiting.url), artKey(req.url)) != 0;
+}
+
+// JPEG Callback: MCU blocks are resampled (nearest neighbour) into the
+// off-screen art buffer so any decode size fills the pane exactly (ArtTask only).
+// Each pane pixel (dx,dy) takes source pixel (dx*srcW/S, dy*srcH/S); a block
+// covering source columns [x, x+w) owns pane columns [ceil(x*S/srcW), ceil((x+w)*S/srcW)).
+int JPEGDraw(JPEGDRAW *pDraw) {
+    const int S = ART_PANE_SIZE;
+    int dxStart = (pDraw->x * S + artSrcW - 1) / artSrcW;
+    int dxEnd = ((pDraw->x + pDraw->iWidth) * S + artSrcW - 1) / artSrcW;
+    int dyStart = (pDraw->y * S + artSrcH - 1) / artSrcH;
+    int dyEnd = ((pDraw->y + pDraw->iHeight) * S + artSrcH - 1) / artSrcH;
+    if (dxEnd > S) dxEnd = S;
+    if (dyEnd > S) dyEnd = S;
+
+    for (int dy = dyStart; dy < dyEnd; dy++) {
+        const uint16_t* src = pDraw->pPixels + (dy * artSrcH / S - pDraw->y) * pDraw->iWidth;
+        uint16_t* dst = artBack + dy * S;
+        if (artSrcW == S) {
+            if (dxEnd > dxStart) memcpy(dst + dxStart, src + (dxStart - pDraw->x), (dxEnd - dxStart) * sizeof(uint16_t));
+        } else {
+            for (int dx = dxStart; dx < dxEnd; dx++) dst[dx] = src[dx * artSrcW / S - pDraw->x];
+        }
+    }
+    return artStale(*artDecodeReq) ? 0 : 1; // 0 aborts a stale decode
+}
+
+// --- Flash cache (LittleFS) ---
+
+// Ids become file names: keep to short alphanumerics
+bool artFlashKeyOk(const char* key) {
+    size_t len = strlen(key);
+    if (len == 0 || len >= sizeof(artFiles[0].key)) return false;
+    for (size_t i = 0; i < len; i++) {
+        if (!isalnum((unsigned char)key[i])) return false;
+    }
+    return true;
+}
+
+int artFlashFind(const char* key) {
+    for (int i = 0; i < artFileCount; i++) {
+        if (strcmp(artFiles[i].key, key) == 0) return i;
+    }
+    return -1;
+}
+
+void artFlashRemove(int i) {
+    char path[64];
+    snprintf(path, sizeof(path), ART_FLASH_DIR "/%s", artFiles[i].key);
+    LittleFS.remove(path);
+    artFileBytes -= artFiles[i].size;
+    artFiles[i] = artFiles[--artFileCount];
+}
+
+void artFlashSaveIndex() {
+    File idx = LittleFS.open(ART_FLASH_INDEX, "w");
+    if (!idx) return;
+    for (int i = 0; i < artFileCount; i++) {
+        idx.printf("%s %lu\n", artFiles[i].key, (unsigned long)artFiles[i].lastUsed);
+    }
+    idx.close();
+}
+
+// Boot: rebuild the index from the directory, recency from the saved index
+void artFlashInit() {
+    if (!LittleFS.exists(ART_FLASH_DIR)) LittleFS.mkdir(ART_FLASH_DIR);
+    File dir = LittleFS.open(ART_FLASH_DIR);
+    if (!dir || !dir.isDirectory()) return;
+
+    File f = dir.openNextFile();
+    while (f) {
+        char path[64];
+        snprintf(path, sizeof(path), ART_FLASH_DIR "/%s", f.name());
+        bool keep = artFlashKeyOk(f.name()) && artFileCount < ART_FLASH_MAX_FILES;
+        if (keep) {
+            ArtFileEntry& e = artFiles[artFileCount++];
+            strlcpy(e.key, f.name(), sizeof(e.key));
+            e.size = f.size();
+            e.lastUsed = 0;
+            artFileBytes += e.size;
+        }
+        f.close();
+        if (!keep) LittleFS.remove(path); // Interrupted write (.tmp) or overflow
+        f = dir.openNextFile();
+    }
+    dir.close();
+
+    File idx = LittleFS.open(ART_FLASH_INDEX, "r");
+    while (idx && idx.available()) {
+        String line = idx.readStringUntil('\n');
+        char key[48];
+        unsigned long used;
+        if (sscanf(line.c_str(), "%47s %lu", key, &used) != 2) continue;
+        int i = artFlashFind(key);
+        if (i >= 0) artFiles[i].lastUsed = used;
+        if (used > artFileClock) artFileClock = used;
+    }
+    if (idx) idx.close();
+
+    artFlashReady = true;
+    Serial.printf("Art flash cache: %d covers, %lu bytes\n", artFileCount, (unsigned long)artFileBytes);
+}
+
+// Hit: opens the cached JPEG for streaming and sets *size. Misses are counted here too.
+bool artFlashOpen(const char* key, File& f, int32_t* size) {
+    int i = artFlashReady ? artFlashFind(key) : -1;
+    if (i >= 0) {
+        char path[64];
+        snprintf(path, sizeof(path), ART_FLASH_DIR "/%s", key);
+        f = LittleFS.open(path, "r");
+        if (f && f.size() == artFiles[i].size) {
+            artFiles[i].lastUsed = ++artFileClock;
+            *size = artFiles[i].size;
+            metricCount(M_ART_FLASH_HITS);
+            return true;
+        }
+        if (f) f.close();
+        artFlashRemove(i); // Unreadable: drop it and fetch again
+    }
+    metricCount(M_ART_FLASH_MISSES);
+    return false;
+}
+
+// Evict least recently used covers until a new one of size bytes fits the
+// budget, with room on the partition for the unwritten part of it
+void artFlashMakeRoom(int32_t size, int32_t unwritten) {
+    while (artFileCount > 0 &&
+           (artFileCount >= ART_FLASH_MAX_FILES ||
+            artFileBytes + size > ART_FLASH_BUDGET ||
+            LittleFS.usedBytes() + unwritten + 8192 > LittleFS.totalBytes())) {
+        int lru = 0;
+        for (int i = 1; i < artFileCount; i++) {
+            if (artFiles[i].lastUsed < artFiles[lru].lastUsed) lru = i;
+        }
+        artFlashRemove(lru);
+        metricCount(M_ART_FLASH_EVICTIONS);
+    }
+}
+
+// Start caching a cover as it downloads: make room for expectedSize (0 when
+// unknown, leaving it all to artFlashEndWrite()), then open a temp file.
+// Written aside and renamed on commit, so a power cut never leaves a
+// truncated cover.
+bool artFlashBeginWrite(const char* key, int32_t expectedSize, File& tmp) {
+    if (!artFlashReady || !artFlashKeyOk(key) || expectedSize > ART_FLASH_BUDGET) return false;
+    int existing = artFlashFind(key);
+    if (existing >= 0) artFlashRemove(existing);
+    artFlashMakeRoom(expectedSize, expectedSize);
+
+    char path[64];
+    snprintf(path, sizeof(path), ART_FLASH_DIR "/%s.tmp", key);
+    tmp = LittleFS.open(path, "w");
+    return (bool)tmp;
+}
+
+// Finish the write: keep it only if the whole body made it to flash. Room
+// is made again for the size actually written, which covers bodies without
+// a Content-Length.
+void artFlashEndWrite(const char* key, File& tmp, bool complete) {
+    char path[64], tmpPath[64];
+    snprintf(path, sizeof(path), ART_FLASH_DIR "/%s", key);
+    snprintf(tmpPath, sizeof(tmpPath), ART_FLASH_DIR "/%s.tmp", key);
+    int32_t size = tmp.size();
+    tmp.close();
+    if (!complete || size <= 0 || size > ART_FLASH_BUDGET) {
+        LittleFS.remove(tmpPath);
+        return;
+    }
+    artFlashMakeRoom(size, 0);
+    if (!LittleFS.rename(tmpPath, path)) {
+        LittleFS.remove(tmpPath);
+        return;
+    }
+
+    ArtFileEntry& e = artFiles[artFileCount++];
+    strlcpy(e.key, key, sizeof(e.key));
+    e.size = size;
+    e.lastUsed = ++artFileClock;
+    artFileBytes += size;
+    artFlashSaveIndex();
+}
+
+// --- Streaming source for JPEGDEC's file callbacks ---
+// Either a cached file on flash, or the HTTP body pulled on demand while
+// the decoder runs, so decoding overlaps the download and no whole-file
+// buffer is needed. The network side keeps the last ART_STREAM_WINDOW bytes
+// for the decoder's short backward seeks (header parse -> scan data) and
+// tees everything it receives into the flash cache.
+
+struct ArtSource {
+    const ArtRequest* req;
+    bool network;
+    File file;                       // Flash hit, or the cache copy being written
+    bool caching;                    // Network: file is a tee into the cache
+    Stream* body;
+    int32_t size;                    // Content-Length (or ART_STREAM_MAX when unknown)
+    int32_t received;                // Bytes pulled from the network so far
+    int32_t winLen;                  // window holds bytes [received - winLen, received)
+    bool ended;                      // Body finished or failed
+    uint8_t window[ART_STREAM_WINDOW];
+};
+ArtSource artSrc; // ArtTask only
+
+// Pull the next piece of the body into the window (and the cache copy)
+bool artPull(ArtSource& src) {
+    if (src.ended || src.received >= src.size || artStale(*src.req)) return false;
+    if (src.winLen > ART_STREAM_WINDOW / 2) {
+        memmove(src.window, src.window + src.winLen - ART_STREAM_WINDOW / 2, ART_STREAM_WINDOW / 2);
+        src.winLen = ART_STREAM_WINDOW / 2;
+    }
+    int32_t want = ART_STREAM_WINDOW - src.winLen;
+    if (want > src.size - src.received) want = src.size - src.received;
+    size_t n = src.body->readBytes(src.window + src.winLen, want);
+    if (n == 0) {
+        src.ended = true;
+        return false;
+    }
+    if (src.caching && src.file.write(src.window + src.winLen, n) != n) src.caching = false;
+    src.winLen += n;
+    src.received += n;
+    return true;
+}
+
+int32_t artJpegRead(JPEGFILE* pFile, uint8_t* pBuf, int32_t iLen) {
+    ArtSource& src = *(ArtSource*)pFile->fHandle;
+    if (!src.network) {
+        int32_t n = src.file.read(pBuf, iLen);
+        pFile->iPos += n;
+        return n;
+    }
+    if (pFile->iPos + iLen > src.size) iLen = src.size - pFile->iPos;
+    int32_t copied = 0;
+    while (copied < iLen) {
+        int32_t pos = pFile->iPos + copied;
+        if (pos >= src.received) {
+            if (!artPull(src)) break;
+            continue;
+        }
+        int32_t winStart = src.received - src.winLen;
+        if (pos < winStart) break; // Seeked back past the window
+        int32_t n = src.received - pos;
+        if (n > iLen - copied) n = iLen - copied;
+        memcpy(pBuf + copied, src.window + (pos - winStart), n);
+        copied += n;
+    }
+    pFile->iPos += copied;
+    return copied;
+}
+
+int32_t artJpegSeek(JPEGFILE* pFile, int32_t iPosition) {
+    ArtSource& src = *(ArtSource*)pFile->fHandle;
+    pFile->iPos = iPosition;
+    if (!src.network) src.file.seek(iPosition);
+    return iPosition; // Network: served (or refused) lazily by artJpegRead
+}
+
+void artJpegClose(void* pHandle) {
+    (void)pHandle; // fetchAlbumArt owns the source
+}
+
+// Decode src into artBack at the cheapest scale that covers the pane
+bool decodeAlbumArt(const ArtRequest& req, ArtSource& src) {
+    if (!jpeg.open((void*)&src, src.size, artJpegClose, artJpegRead, artJpegSeek, JPEGDraw)) return false;
+
+    // Cheapest power-of-two decode that still covers the pane (640px -> 320),
+    // then JPEGDraw resamples it to exactly 240x240
+    int scale = 0, shift = 0;
+    int smallest = jpeg.getWidth() < jpeg.getHeight() ? jpeg.getWidth() : jpeg.getHeight();
+    if (smallest >= ART_PANE_SIZE * 8) { scale = JPEG_SCALE_EIGHTH; shift = 3; }
+    else if (smallest >= ART_PANE_SIZE * 4) { scale = JPEG_SCALE_QUARTER; shift = 2; }
+    else if (smallest >= ART_PANE_SIZE * 2) { scale = JPEG_SCALE_HALF; shift = 1; }
+    artSrcW = jpeg.getWidth() >> shift;
+    artSrcH = jpeg.getHeight() >> shift;
+    if (artSrcW <= 0 || artSrcH <= 0) { jpeg.close(); return false; }
+
+    memset(artBack, 0, ART_PANE_SIZE * ART_PANE_SIZE * sizeof(uint16_t));
+    artDecodeReq = &req;
+
+    jpeg.setPixelType(RGB565_BIG_ENDIAN);
+    bool decoded = jpeg.decode(0, 0, scale);
+    jpeg.close();
+    return decoded && !artStale(req);
+}
+
+// Stream the cover from the CDN, decoding as it arrives (unless decode is
+// false: prefetch that only warms the flash cache). ArtTask only.
+bool streamAlbumArt(const ArtRequest& req, bool decode) {
+    if (WiFi.status() != WL_CONNECTED) return false;
+
+    if (!apiBegin(artConn, req.url)) return false;
+    bool decoded = false;
+    bool complete = false;
+    if (apiSend(artConn, "GET") == 200) {
+        int len = artConn.http.getSize();
+        artSrc.req = &req;
+        artSrc.network = true;
+        artSrc.body = &apiBody(artConn);
+        artSrc.size = len > 0 ? len : ART_STREAM_MAX;
+        artSrc.received = 0;
+        artSrc.winLen = 0;
+        artSrc.ended = false;
+        // No Content-Length: nothing is evicted until the real size is known
+        artSrc.caching = artFlashBeginWrite(artKey(req.url), len > 0 ? len : 0, artSrc.file);
+
+        if (decode) decoded = decodeAlbumArt(req, artSrc);
+        // Pull what the decoder didn't need (trailer) so the cache copy is whole
+        while (artPull(artSrc)) {}
+        complete = (len > 0) ? (artSrc.received == len) : (artSrc.ended && artSrc.received > 0);
+        if (artStale(req)) complete = false;
+
+        // Only keep covers that decoded (or weren't meant to be decoded yet)
+        bool keep = complete && artSrc.caching && (decoded || !decode);
+        if (artSrc.file) artFlashEndWrite(artKey(req.url), artSrc.file, keep);
+    }
+    if (!complete) artConn.client.stop(); // Don't drain a body we abandoned
+    apiEnd(artConn);
+
+    return decode ? (decoded && complete) : complete;
+}
+
+// Load (flash or CDN) + decode into artBack, then swap it into the cache and publish it
+bool fetchAlbumArt(const ArtRequest& req) {
+    if (!artBack || artSlotCount == 0) return false;
+    // Without room for several decodes a prefetch only warms the flash cache
+    bool decode = !(req.prefetch && artSlotCount <= ART_PREFETCH_COUNT);
+
+    // Repeat albums come straight off flash, no network at all
+    bool ok;
+    artSrc.req = &req;
+    artSrc.network = false;
+    uint32_t start = micros();
+    if (artFlashOpen(artKey(req.url), artSrc.file, &artSrc.size)) {
+        ok = decode ? decodeAlbumArt(req, artSrc) : true;
+        artSrc.file.close();
+        if (ok && decode) metricObserve(M_ART_FLASH, micros() - start);
+    } else {
+        ok = streamAlbumArt(req, decode);
+        if (ok && decode) metricObserve(M_ART_CDN, micros() - start);
+    }
+    if (!ok || artStale(req)) return false;
+    if (!decode) return true;
+
+    // The evicted slot's buffer becomes the next decode target
+    xSemaphoreTake(artMutex, portMAX_DELAY);
+    int slot = artCacheVictim();
+    if (artSlots[slot].key[0]) metricCount(M_ART_EVICTIONS);
+    uint16_t* done = artBack;
+    artBack = artSlots[slot].pixels;
+    artSlots[slot].pixels = done;
+    strlcpy(artSlots[slot].key, artKey(req.url), sizeof(artSlots[slot].key));
+    artSlots[slot].lastUsed = ++artUseClock;
+    if (!req.prefetch) artPublish(slot, req.generation);
+    xSemaphoreGive(artMutex);
+    if (!req.prefetch) uiNotify(UI_WAKE_ART);
+    return true;
+}
+
+// Read the next covers from the playback queue (ArtTask, only when idle).
+// Runs on its own session (queueConn) with SpotifyTask's token. A 401 is not
+// renewed or retried here: this track's prefetch is skipped, and SpotifyTask
+// renews the token on its next request for the following one to pick up.
+int fetchUpcomingArt(ArtRequest* out, int max) {
+    if (WiFi.status() != WL_CONNECTED) return 0;
+    if (!apiBegin(queueConn, SPOT_QUEUE)) return 0;
+
+    apiAuthorize(queueConn);
+
+    int count = 0;
+    if (apiSend(queueConn, "GET") == 200) {
+        JsonDocument doc;
+        DeserializationError error = deserializeJson(doc, apiBody(queueConn), DeserializationOption::Filter(queueFilter));
+        if (!error) {
+            for (JsonVariant item : doc["queue"].as<JsonArray>()) {
+                if (count >= max) break;
+                const char* url = pickAlbumImage(item["album"]["images"]);
+                if (!url) continue;
+                out[count].generation = 0;
+                out[count].prefetch = true;
+                strlcpy(out[count].url, url, sizeof(out[count].url));
+                count++;
+            }
+        }
+    }
+    apiEnd(queueConn);
+    return count;
+}
+
+void artTask(void * parameter) {
+    Serial.println("Status: Art Task Started (Core 0)");
+    ArtRequest req;
+    ArtRequest upcoming[ART_PREFETCH_COUNT];
+    int upcomingCount = 0, upcomingNext = 0;
+    char prefetchedTrack[64] = "";
+
+    for (;;) {
+        // Foreground requests first; prefetch work only fills idle time
+        if (xQueueReceive(artQueue, &req, 0) != pdTRUE) {
+            char track[64];
+            xSemaphoreTake(artMutex, portMAX_DELAY);
+            strlcpy(track, artPrefetchTrack, sizeof(track));
+            xSemaphoreGive(artMutex);
+            if (track[0] && strcmp(track, prefetchedTrack) != 0) {
+                strlcpy(prefetchedTrack, track, sizeof(prefetchedTrack));
+                upcomingCount = fetchUpcomingArt(upcoming, ART_PREFETCH_COUNT);
+                upcomingNext = 0;
+                continue;
+            }
+            if (upcomingNext >= upcomingCount) {
+                xSemaphoreTake(artWake, portMAX_DELAY);
+                continue;
+            }
+            req = upcoming[upcomingNext++];
+        }
+        if (artStale(req)) continue; // Superseded while queued
+
+        // Already decoded (typically prefetched): publish it, or nothing to do
+        xSemaphoreTake(artMutex, portMAX_DELAY);
+        int slot = artCacheFind(artKey(req.url));
+        bool published = slot >= 0 && !req.prefetch;
+        if (published) {
+            artPublish(slot, req.generation);
+            artPendingKey[0] = '\0';
+        }
+        xSemaphoreGive(artMutex);
+        if (published) uiNotify(UI_WAKE_ART);
+        if (slot >= 0) continue;
+
+        unsigned long start = millis();
+        if (fetchAlbumArt(req)) {
+            Serial.printf(req.prefetch ? "Art prefetched in %lu ms\n" : "Art ready in %lu ms\n", millis() - start);
+        } else if (artStale(req)) {
+            Serial.println(req.prefetch ? "Art prefetch yielded to a track change"
+                                        : "Art request cancelled (track changed)");
+        }
+
+        if (!req.prefetch) {
+            xSemaphoreTake(artMutex, portMAX_DELAY);
+            if (req.generation == artWantedGen) artPendingKey[0] = '\0';
+            xSemaphoreGive(artMutex);
+        }
     }
-    http.end();
+}
+
+// UI side: ask for a cover. Served straight from the cache when we have it
+// (returns true, blitted on the next loop); otherwise replaces any request
+// still waiting in the queue. A repeat of the cover already being fetched
+// just keeps waiting for it.
+bool requestAlbumArt(const char* url) {
+    const char* key = artKey(url);
+    xSemaphoreTake(artMutex, portMAX_DELAY);
+    int slot = artCacheFind(key);
+    if (slot >= 0) {
+        artWantedGen = artWantedGen + 1; // Cancels any other cover in flight
+        artPublish(slot, artWantedGen);
+        artPendingKey[0] = '\0';
+        xSemaphoreGive(artMutex);
+        uiNotify(UI_WAKE_ART);
+        metricCount(M_ART_HITS);
+        return true;
+    }
+    if (strcmp(key, artPendingKey) != 0) {
+        ArtRequest req;
+        req.generation = artWantedGen + 1;
+        req.prefetch = false;
+        strlcpy(req.url, url, sizeof(req.url));
+        strlcpy(artPendingKey, key, sizeof(artPendingKey));
+        artWantedGen = req.generation;
+        metricCount(M_ART_MISSES);
+        xQueueOverwrite(artQueue, &req);
+        xSemaphoreGive(artWake);
+    }
+    xSemaphoreGive(artMutex);
+    return false;
+}
+
+// UI side: the track changed, so warm the covers that follow it. Posted after
+// the current cover's request so ArtTask always serves that one first.
+void requestArtPrefetch(const char* trackId) {
+    if (!artMutex) return;
+    xSemaphoreTake(artMutex, portMAX_DELAY);
+    strlcpy(artPrefetchTrack, trackId, sizeof(artPrefetchTrack));
+    xSemaphoreGive(artMutex);
+    xSemaphoreGive(artWake);
+}
+
+// UI side: push the finished cover to the panel, if it is still the one we want
+// Black out the pane while the cover loads. Under a popup only the parts
+// around it are painted and the save-under copy is blacked for the rest.
+void artPaneClear() {
+    artShownSlot = -1;
+    if (!popupShown || !popupSaved) {
+        tft.fillRect(ART_PANE_X, ART_PANE_Y, ART_PANE_SIZE, ART_PANE_SIZE, C_BLACK);
+        return;
+    }
+    const int paneR = ART_PANE_X + ART_PANE_SIZE, paneB = ART_PANE_Y + ART_PANE_SIZE;
+    int x0 = std::max(ART_PANE_X, POPUP_X), x1 = std::min(paneR, POPUP_X + POPUP_W);
+    int y0 = std::max(ART_PANE_Y, POPUP_Y), y1 = std::min(paneB, POPUP_Y + POPUP_H);
+    if (x0 >= x1 || y0 >= y1) {
+        tft.fillRect(ART_PANE_X, ART_PANE_Y, ART_PANE_SIZE, ART_PANE_SIZE, C_BLACK);
+        return;
+    }
+    tft.fillRect(ART_PANE_X, ART_PANE_Y, ART_PANE_SIZE, y0 - ART_PANE_Y, C_BLACK);
+    tft.fillRect(ART_PANE_X, y1, ART_PANE_SIZE, paneB - y1, C_BLACK);
+    tft.fillRect(ART_PANE_X, y0, x0 - ART_PANE_X, y1 - y0, C_BLACK);
+    tft.fillRect(x1, y0, paneR - x1, y1 - y0, C_BLACK);
+    for (int row = y0; row < y1; row++) {
+        memset(popupSaveUnder + (size_t)(row - POPUP_Y) * POPUP_W + (x0 - POPUP_X), 0, (x1 - x0) * sizeof(uint16_t));
+    }
+}
+
+void blitAlbumArt() {
+    if (!artReady) return;
+    if (xSemaphoreTake(artMutex, 0) != pdTRUE) return; // ArtTask mid-swap, try next loop
+    if (artReady && artReadyGen == artWantedGen && artReadySlot >= 0) {
+        unsigned long start = micros();
+        panelPushImage(ART_PANE_X, ART_PANE_Y, ART_PANE_SIZE, ART_PANE_SIZE, artSlots[artReadySlot].pixels);
+        artShownSlot = artReadySlot;
+        strlcpy(artShownKey, artSlots[artReadySlot].key, sizeof(artShownKey));
+        metricObserve(M_ART_BLIT, micros() - start);
+    }
+    artReady = false;
+    xSemaphoreGive(artMutex);
 }
 
 // ============================================================
@@ -798,83 +3206,245 @@ void connect_to_wifi() {
     delay(1000);
 }
 
+// Delay until the next poll, from what could change and when
+unsigned long pollInterval(unsigned long now, unsigned long fastUntil) {
+    if ((long)(fastUntil - now) > 0) return POLL_FAST_MS;
+
+    bool playing = false;
+    long remaining = -1;
+    if (xSemaphoreTake(dataMutex, 100) == pdTRUE) {
+        playing = playbackClock.valid && playbackClock.playing;
+        if (playbackClock.durationMS > 0) remaining = playbackClock.durationMS - playbackPosition(now);
+        xSemaphoreGive(dataMutex);
+    }
+    if (!playing) return POLL_PAUSED_MS;
+    if (remaining >= 0 && remaining < POLL_PLAYING_MS) {
+        // Catch the next track as soon as it starts
+        return (remaining > 0) ? remaining + POLL_TRACK_END_MS : POLL_FAST_MS;
+    }
+    return POLL_PLAYING_MS;
+}
+
+// A skip/restart left the queue: its confirmation window starts now
+void skipSent() {
+    if (xSemaphoreTake(dataMutex, 100) == pdTRUE) {
+        if (pending.skipsUnsent > 0) pending.skipsUnsent--;
+        pending.skipAt = millis();
+        xSemaphoreGive(dataMutex);
+    }
+}
+
+// A skip posted while loop() couldn't take dataMutex: show it now, so every
+// queued skip has its optimisticSkip(). Returns whether PREV restarts.
+bool skipLate(int dir) {
+    bool restart = false;
+    if (xSemaphoreTake(dataMutex, portMAX_DELAY) == pdTRUE) {
+        restart = dir < 0 && playbackPosition(millis()) > SMART_PREV_MS;
+        optimisticSkip(dir, restart);
+        xSemaphoreGive(dataMutex);
+        uiNotify(UI_WAKE_DATA);
+    }
+    return restart;
+}
+
+// Sends one (merged) command. Returns true if it changes playback state, i.e.
+// the next polls should come quickly to pick the change up.
+bool runCommand(const Command& cmd) {
+    static const char* names[] = { "next", "prev", "play", "volume", "like", "refresh" };
+    Serial.printf("CMD: %s (%d), queued %lu ms\n", names[cmd.type], cmd.arg, millis() - cmd.pressedAt);
+
+    RequestTiming timing;
+    switch (cmd.type) {
+        case CMD_NEXT:
+            if (cmd.arg < 0) skipLate(1);
+            sendSpotifyCommand("POST", RequestUrl(SPOT_NEXT), &timing);
+            skipSent();
+            latencyAnswered(cmd.trace, timing.sentUs, timing.responseUs);
+            return true;
+
+        case CMD_PREV:
+            // Smart Previous: restart vs. previous track was decided on press,
+            // or is decided here if the press couldn't see the position
+            if (cmd.arg < 0 ? skipLate(-1) : cmd.arg) {
+                RequestUrl seekUrl(SPOT_SEEK);
+                seekUrl.param("position_ms", 0L);
+                sendSpotifyCommand("PUT", seekUrl, &timing);
+            } else {
+                sendSpotifyCommand("POST", RequestUrl(SPOT_PREV), &timing);
+            }
+            skipSent();
+            latencyAnswered(cmd.trace, timing.sentUs, timing.responseUs);
+            return true;
+
+        case CMD_PLAY: {
+            // Toggle posted without the state: flip what's on screen now
+            bool play = cmd.arg > 0;
+            if (cmd.arg < 0 && xSemaphoreTake(dataMutex, portMAX_DELAY) == pdTRUE) {
+                play = !sharedState.isPlaying;
+                optimisticPlay(play);
+                xSemaphoreGive(dataMutex);
+                uiNotify(UI_WAKE_DATA);
+            }
+            sendSpotifyCommand("PUT", RequestUrl(play ? SPOT_PLAY : SPOT_PAUSE), &timing);
+            latencyAnswered(cmd.trace, timing.sentUs, timing.responseUs);
+            return true;
+        }
+
+        case CMD_VOLUME:
+            // Timed from the first step the next PUT carries
+            if (xSemaphoreTake(dataMutex, 100) == pdTRUE) {
+                if (volumeCtl.trace < 0) volumeCtl.trace = cmd.trace;
+                else latencyDrop(cmd.trace);
+                xSemaphoreGive(dataMutex);
+            } else {
+                latencyDrop(cmd.trace);
+            }
+            volumeService();
+            return false;
+
+        case CMD_LIKE:
+            saveToLiked(&timing);
+            latencyAnswered(cmd.trace, timing.sentUs, timing.responseUs);
+            return false;
+
+        case CMD_REFRESH:
+            return false;
+    }
+    return false;
+}
+
+// Sends the volume target if it moved and the last PUT is far enough back.
+// Runs on spotifyTask only, so the blocking PUT is the one in flight and any
+// steps pressed meanwhile go out together in the next one. Returns true if a
+// target is still waiting for its slot.
+bool volumeService() {
+    int level = -1;
+    bool waiting = false;
+    int8_t trace = -1;
+    if (xSemaphoreTake(dataMutex, 100) != pdTRUE) return true;
+    if (volumeCtl.target >= 0 && volumeCtl.target != volumeCtl.sent) {
+        if (volumeCtl.sent < 0 || millis() - volumeCtl.sentAt >= VOLUME_MIN_GAP_MS) {
+            level = volumeCtl.target;
+            volumeCtl.sent = level;
+            volumeCtl.sentAt = millis();
+        } else {
+            waiting = true;
+        }
+    }
+    // Steps that cancelled out send nothing
+    if (level >= 0 || !waiting) {
+        trace = volumeCtl.trace;
+        volumeCtl.trace = -1;
+    }
+    xSemaphoreGive(dataMutex);
+    if (level < 0) {
+        latencyDrop(trace);
+        return waiting;
+    }
+
+    RequestTiming timing;
+    int code = setSpotifyVolume(level, &timing);
+    latencyAnswered(trace, timing.sentUs, timing.responseUs);
+    if (xSemaphoreTake(dataMutex, 100) == pdTRUE) {
+        volumeCtl.sentAt = millis(); // Gap counts from the response
+        if (code < 200 || code >= 300) {
+            // Device refused (e.g. no volume control): drop back to the polled level
+            Serial.printf("Volume: PUT %d%% failed (%d)\n", level, code);
+            if (volumeCtl.target == level) volumeCtl.target = -1;
+            volumeCtl.sent = -1;
+        }
+        waiting = volumeCtl.target >= 0 && volumeCtl.target != volumeCtl.sent;
+        xSemaphoreGive(dataMutex);
+    }
+    return waiting;
+}
+
 // --- BACKGROUND TASK ---
 void spotifyTask(void * parameter) {
     Serial.println("Status: Spotify Task Started (Core 0)");
     unsigned long lastUpdate = 0;
+    unsigned long pollDelay = 0;
+    unsigned long fastUntil = 0;  // Fast polling after a command, until this time
     bool forceUpdate = true;
 
     for(;;) {
-        // 1. Handle Commands
-        if (triggerNext) {
-            sendSpotifyCommand("POST", SPOT_NEXT);
-            triggerNext = false; forceUpdate = true;
-            vTaskDelay(200 / portTICK_PERIOD_MS);
-        }
-        if (triggerPrev) {
-            // Smart Previous Logic
-            long estimatedProgress = sharedState.progressMS;
-            if (sharedState.isPlaying) estimatedProgress += (millis() - lastUpdate);
-
-            if (estimatedProgress > 10000) { 
-                char seekUrl[128];
-                snprintf(seekUrl, sizeof(seekUrl), "%s?position_ms=0", SPOT_SEEK);
-                sendSpotifyCommand("PUT", seekUrl);
-            } else {
-                sendSpotifyCommand("POST", SPOT_PREV);
+        // 1. Handle Commands: drain the queue back to back, merging what's
+        // already waiting behind each one, and poll once the burst is over
+        Command cmd;
+        if (xQueueReceive(cmdQueue, &cmd, 0) == pdTRUE) {
+            Command next;
+            while (xQueuePeek(cmdQueue, &next, 0) == pdTRUE && commandMerge(cmd, next)) {
+                xQueueReceive(cmdQueue, &next, 0);
+                latencyDrop(next.trace); // Timed by the press it merged into
             }
-            triggerPrev = false; forceUpdate = true;
-            vTaskDelay(200 / portTICK_PERIOD_MS);
-        }
-        if (triggerPlay) {
-            if (sharedState.isPlaying) sendSpotifyCommand("PUT", SPOT_PAUSE);
-            else sendSpotifyCommand("PUT", SPOT_PLAY);
-            triggerPlay = false; forceUpdate = true;
-            vTaskDelay(200 / portTICK_PERIOD_MS);
-        }
-        if (triggerVolumeChange != 0) {
-            int newVol = sharedState.volumePercent + triggerVolumeChange;
-            if (newVol > 100) newVol = 100;
-            if (newVol < 0) newVol = 0;
-            setSpotifyVolume(newVol);
-            triggerVolumeChange = 0;
-        }
-        if (triggerLike) {
-            saveToLiked();
-            triggerLike = false;
-            vTaskDelay(500 / portTICK_PERIOD_MS);
+            // Commands just sent: keep polling fast until their effect shows up
+            if (runCommand(cmd)) fastUntil = millis() + POLL_FAST_WINDOW_MS;
+            if (cmd.type != CMD_VOLUME && cmd.type != CMD_LIKE) forceUpdate = true;
+            continue;
         }
 
-        // --- FIX: Check for Wake Up Trigger ---
-        if (triggerRefresh) {
-            forceUpdate = true;
-            triggerRefresh = false;
+        unsigned long now = millis();
+
+        // Renew the token ahead of expiry, between commands, so requests
+        // never meet a 401 (asleep: the wake-up pass gets here before polling)
+        if (tokenRenewAt != 0 && !isSleeping && (long)(now - tokenRenewAt) >= 0) {
+            if (!renewAccessToken(tokenGeneration)) tokenRenewAt = millis() + TOKEN_RETRY_MS;
+            now = millis();
         }
 
         // 2. Poll Data
-        unsigned long now = millis();
+        // A 429 holds every poll (forced or not) until its Retry-After passes
+        bool rateLimited = apiConn.retryAt != 0 && (long)(apiConn.retryAt - now) > 0;
         // --- FIX: Only poll if forced (waking up) OR (not sleeping AND time has passed) ---
         // This stops polling while sleeping, but allows immediate update on wake
-        if (forceUpdate || (!isSleeping && (now - lastUpdate > SPOTIFY_REFRESH_RATE_MS))) {
-            // DEBUG: Log before call
-            // Serial.println("DEBUG: Updating Data..."); 
-            if (getSpotifyData()) {
-                newDataAvailable = true;
-                // Serial.println("DEBUG: Data Updated OK");
-            } else {
-                // Serial.println("DEBUG: Data Update Failed");
+        if (!rateLimited && (forceUpdate || (!isSleeping && (now - lastUpdate >= pollDelay)))) {
+            apiConn.retryAt = 0;
+            bool changed = false;
+            int code = getSpotifyData(&changed);
+            pollsIssued++;
+            metricCount((code == 200 || code == 204) ? M_POLL_OK : M_POLL_FAIL);
+            metricsSample();
+            if (code == 200 || code == 204) {
+                if (xSemaphoreTake(dataMutex, 100) == pdTRUE) {
+                    latencyPolled();
+                    newDataAvailable = true;
+                    xSemaphoreGive(dataMutex);
+                }
+                uiNotify(UI_WAKE_DATA);
+                if (changed) {
+                    pollsChanged++;
+                    fastUntil = now; // The command landed; back to the normal rate
+                }
             }
             lastUpdate = now;
             forceUpdate = false;
+            // Failed poll: 401 already refreshed the token, so retry soon
+            pollDelay = (code == 200 || code == 204 || code == 429) ? pollInterval(millis(), fastUntil)
+                                                                    : POLL_FAST_MS;
+            if (pollsIssued % POLL_STATS_EVERY == 0) {
+                Serial.printf("Poll: issued=%lu changed=%lu (%lu%%) rateLimited=%lu next=%lu ms\n",
+                              (unsigned long)pollsIssued, (unsigned long)pollsChanged,
+                              (unsigned long)(pollsChanged * 100 / pollsIssued),
+                              (unsigned long)apiConn.rateLimited, pollDelay);
+                Serial.printf("Poll: json allocs=%lu heap=%lu (last parse), arena peak=%u/%u B\n",
+                              (unsigned long)playerArena.allocs, (unsigned long)playerArena.heapAllocs,
+                              (unsigned)playerArena.peak, (unsigned)JSON_ARENA_SIZE);
+            }
         }
-        vTaskDelay(200 / portTICK_PERIOD_MS);
+
+        // Sleep until the next command arrives (or the poll clock ticks);
+        // sooner if a coalesced volume target is waiting for its slot
+        bool volumeWaiting = volumeService();
+        xQueuePeek(cmdQueue, &cmd, (volumeWaiting ? VOLUME_MIN_GAP_MS / 4 : 200) / portTICK_PERIOD_MS);
     }
 }
 
 // --- MAIN SETUP ---
 void setup() {
+    Serial.setTxBufferSize(METRIC_TX_BUFFER);
     Serial.begin(115200);
     Serial.println("\n\n--- BOOT ---");
+    metricsMutex = xSemaphoreCreateMutex();
     
     #ifdef ENABLE_ALBUM_ART
     setCpuFrequencyMhz(240);
@@ -898,6 +3468,14 @@ void setup() {
     // Init TFT_eSPI
     tft.init();
     tft.setRotation(1); // LANDSCAPE 480x320
+#if PANEL_DMA
+    size_t bandBytes = PANEL_DMA_PIXELS * PANEL_BYTES_PER_PIXEL;
+    panelDmaBands[0] = (uint8_t*)heap_caps_malloc(bandBytes, MALLOC_CAP_DMA);
+    panelDmaBands[1] = (uint8_t*)heap_caps_malloc(bandBytes, MALLOC_CAP_DMA);
+    panelDmaReady = panelDmaBands[0] && panelDmaBands[1] && tft.initDMA();
+    Serial.printf("Panel DMA: %s\n", panelDmaReady ? "on" : "off (blocking pushes)");
+#endif
+    compositorInit();
     
     // STARTUP DIAGNOSTICS: Color Cycle & Text Test
     tft.fillScreen(C_RED);
@@ -917,11 +3495,24 @@ void setup() {
     tft.setTextWrap(false); 
     
 #ifdef ENABLE_ALBUM_ART
-    jpgBuffer = (uint8_t*)malloc(JPG_BUFFER_SIZE);
-    if (!jpgBuffer) {
+    // 240x240 RGB565 frames (~112 KB each): a decode target plus the cache
+    // slots. With PSRAM keep ART_CACHE_SLOTS covers, without it just one.
+    size_t artBytes = ART_PANE_SIZE * ART_PANE_SIZE * sizeof(uint16_t);
+    int wantSlots = psramFound() ? ART_CACHE_SLOTS : 1;
+    artBack = (uint16_t*)(psramFound() ? ps_malloc(artBytes) : malloc(artBytes));
+    while (artBack && artSlotCount < wantSlots) {
+        uint16_t* px = (uint16_t*)(psramFound() ? ps_malloc(artBytes) : malloc(artBytes));
+        if (!px) break;
+        artSlots[artSlotCount].key[0] = '\0';
+        artSlots[artSlotCount].pixels = px;
+        artSlots[artSlotCount].lastUsed = 0;
+        artSlotCount++;
+    }
+    Serial.printf("Art cache: %d slot(s)\n", artSlotCount);
+    if (!artBack || artSlotCount == 0) {
         tft.setCursor(10, 100);
         tft.setTextColor(C_RED, C_BLACK);
-        tft.println("RAM FAIL: No JPEG Buffer");
+        tft.println("RAM FAIL: No Art Buffer");
         delay(2000);
     } else {
         tft.setCursor(10, 100);
@@ -929,14 +3520,37 @@ void setup() {
         tft.println("RAM OK");
         delay(500);
     }
+
+#endif
+
+    // LittleFS holds the smooth fonts and the covers already seen (survive reboots)
+    if (LittleFS.begin(true)) {
+        fontsInit();
+#ifdef ENABLE_ALBUM_ART
+        artFlashInit();
 #endif
+    } else {
+        Serial.println("LittleFS mount failed: GLCD font only, art flash cache disabled");
+    }
 
     dataMutex = xSemaphoreCreateMutex();
+    tokenMutex = xSemaphoreCreateMutex();
+    tokenRefreshMutex = xSemaphoreCreateMutex();
+    if (!playerArena.begin(JSON_ARENA_SIZE)) Serial.println("JSON arena alloc failed, parsing on the heap");
+    buildPlayerFilter();
+    cmdQueue = xQueueCreate(CMD_QUEUE_LEN, sizeof(Command));
+    latencyMutex = xSemaphoreCreateMutex();
+    apiInit();
 
     // Setup Buttons
     btnPrev.begin(PIN_PREV); btnPrev.setTapHandler(onPrevClick); btnPrev.setLongClickTime(500); 
     btnPlay.begin(PIN_PLAY); btnPlay.setTapHandler(onPlayClick); btnPlay.setLongClickTime(1000); 
     btnNext.begin(PIN_NEXT); btnNext.setTapHandler(onNextClick); btnNext.setLongClickTime(500);
+    uiTaskHandle = xTaskGetCurrentTaskHandle();
+    attachInterrupt(digitalPinToInterrupt(PIN_PREV), onButtonEdge, CHANGE);
+    attachInterrupt(digitalPinToInterrupt(PIN_PLAY), onButtonEdge, CHANGE);
+    attachInterrupt(digitalPinToInterrupt(PIN_NEXT), onButtonEdge, CHANGE);
+    Serial.onReceive([]() { uiNotify(UI_WAKE_SERIAL); });
 
     // 2. Connect WiFi
     connect_to_wifi();
@@ -990,7 +3604,16 @@ void setup() {
         }
     }
 
-    // 3. Start Background Task
+    // 3. Start Background Tasks
+#ifdef ENABLE_ALBUM_ART
+    artQueue = xQueueCreate(1, sizeof(ArtRequest));
+    artMutex = xSemaphoreCreateMutex();
+    artWake = xSemaphoreCreateBinary();
+    apiInitConnection(artConn);
+    apiInitConnection(queueConn);
+    buildQueueFilter();
+    xTaskCreatePinnedToCore(artTask, "ArtTask", 16384, NULL, 1, &artTaskHandle, 0);
+#endif
     xTaskCreatePinnedToCore(spotifyTask, "SpotifyTask", 32768, NULL, 1, &spotifyTaskHandle, 0);
     
     Serial.println("Status: Setup Complete. Loop Starting.");
@@ -999,6 +3622,8 @@ void setup() {
 
 // --- MAIN LOOP ---
 void loop() {
+    uiWait();
+    consolePoll();
     btnPrev.loop();
     btnPlay.loop();
     btnNext.loop();
@@ -1018,6 +3643,7 @@ void loop() {
         isSleeping = true;
         digitalWrite(TFT_BL, LOW); 
         tft.fillScreen(C_BLACK);
+        compositorScreenCleared();
         Serial.println("Entering Sleep Mode...");
     }
 
@@ -1067,12 +3693,7 @@ void loop() {
                 delay(2000);
                 ESP.restart();
              } else {
-                 clearScreen(); // Clear popup
-                 // Force full redraw
-                 if (xSemaphoreTake(dataMutex, 10) == pdTRUE) {
-                    newDataAvailable = true;
-                    xSemaphoreGive(dataMutex);
-                 }
+                 dismissPopup(); // Restore what was under it
              }
         }
         isResetting = false;
@@ -1088,7 +3709,11 @@ void loop() {
             showPopup("SAVED TO LIKED", C_MAGENTA); // Reusing popup style
             showFeedbackMessage = true;
             feedbackMessageClearTime = now + 3000;
-            triggerLike = true; 
+            if (xSemaphoreTake(dataMutex, 10) == pdTRUE) {
+                optimisticLike();
+                xSemaphoreGive(dataMutex);
+            }
+            postCommand(CMD_LIKE, 0);
         }
     } else {
         playPressTime = 0;
@@ -1097,11 +3722,7 @@ void loop() {
     // Clear Feedback Message
     if (showFeedbackMessage && now > feedbackMessageClearTime) {
         showFeedbackMessage = false;
-        clearScreen();
-        if (xSemaphoreTake(dataMutex, 10) == pdTRUE) {
-            newDataAvailable = true;
-            xSemaphoreGive(dataMutex);
-        }
+        dismissPopup();
     }
 
     // 4. Volume Control
@@ -1109,9 +3730,12 @@ void loop() {
         // NEXT (Vol Up)
         if (btnNext.isPressed()) {
             if (nextPressTime == 0) nextPressTime = now;
-            if (now - nextPressTime > 800) {
-                if (now - lastVolRepeat > 500) {
-                    triggerVolumeChange = 10;
+            if (now - nextPressTime > VOLUME_HOLD_MS) {
+                if (now - lastVolRepeat > VOLUME_REPEAT_MS) {
+                    if (xSemaphoreTake(dataMutex, 10) == pdTRUE) {
+                        volumeStep(VOLUME_STEP);
+                        xSemaphoreGive(dataMutex);
+                    }
                     lastVolRepeat = now;
                     wakeUp(); 
                 }
@@ -1121,9 +3745,12 @@ void loop() {
         // PREV (Vol Down)
         if (btnPrev.isPressed()) {
             if (prevPressTime == 0) prevPressTime = now;
-            if (now - prevPressTime > 800) {
-                if (now - lastVolRepeat > 500) {
-                    triggerVolumeChange = -10;
+            if (now - prevPressTime > VOLUME_HOLD_MS) {
+                if (now - lastVolRepeat > VOLUME_REPEAT_MS) {
+                    if (xSemaphoreTake(dataMutex, 10) == pdTRUE) {
+                        volumeStep(-VOLUME_STEP);
+                        xSemaphoreGive(dataMutex);
+                    }
                     lastVolRepeat = now;
                     wakeUp();
                 }
@@ -1136,11 +3763,14 @@ void loop() {
         if (newDataAvailable) {
             #ifdef ENABLE_ALBUM_ART
             updateDisplay();
-            // Draw Art if changed
+            // Request Art if changed (cache hit or ArtTask fetch, we blit when ready)
             if (strlen(sharedState.imageUrl) > 5 && strcmp(sharedState.imageUrl, lastImageUrl) != 0) {
                 strlcpy(lastImageUrl, sharedState.imageUrl, 256);
-                tft.fillRect(240, 40, 240, 240, C_BLACK);
-                drawAlbumArt(sharedState.imageUrl);
+                if (!requestAlbumArt(sharedState.imageUrl)) artPaneClear();
+            }
+            if (strcmp(sharedState.trackID, lastPrefetchTrack) != 0) {
+                strlcpy(lastPrefetchTrack, sharedState.trackID, sizeof(lastPrefetchTrack));
+                if (lastPrefetchTrack[0]) requestArtPrefetch(lastPrefetchTrack);
             }
             newDataAvailable = false;
             #else
@@ -1150,5 +3780,22 @@ void loop() {
         }
         xSemaphoreGive(dataMutex);
     }
-}
+
+    // 6. Progress clock: advance the bar between polls at a steady frame rate
+    if (!isSleeping && now - lastProgressFrame >= PROGRESS_FRAME_MS) {
+        if (xSemaphoreTake(dataMutex, 0) == pdTRUE) {
+            lastProgressFrame = now;
+            drawProgress(false);
+            compositorEndFrame();
+            xSemaphoreGive(dataMutex);
+        }
+    }
+
+    // 7. Marquee titles (never over a popup)
+    if (!isSleeping && !showFeedbackMessage && !isResetting) marqueeTick(now);
+
+    #ifdef ENABLE_ALBUM_ART
+    // 8. Blit finished Album Art (never over a popup)
+    if (!showFeedbackMessage && !isResetting) blitAlbumArt();
+    #endif
 }
@@ -0,0 +1,158 @@
+"""Minimal baseline JPEG writer for mock album covers (no third-party deps).
+
+Covers are flat-shaded 16x16 cells, so every 8x8 block is constant and only
+DC coefficients need coding. That keeps encoding instant in pure Python while
+still producing real 4:2:0 baseline files that JPEGDEC decodes normally.
+Optional COM padding inflates a file to a realistic CDN size for bandwidth
+tests without changing the picture.
+"""
+
+import hashlib
+import struct
+
+# ITU-T T.81 Annex K tables
+_LUMA_Q = [16, 11, 10, 16, 24, 40, 51, 61, 12, 12, 14, 19, 26, 58, 60, 55,
+           14, 13, 16, 24, 40, 57, 69, 56, 14, 17, 22, 29, 51, 87, 80, 62,
+           18, 22, 37, 56, 68, 109, 103, 77, 24, 35, 55, 64, 81, 104, 113, 92,
+           49, 64, 78, 87, 103, 121, 120, 101, 72, 92, 95, 98, 112, 100, 103, 99]
+_CHROMA_Q = [17, 18, 24, 47, 99, 99, 99, 99, 18, 21, 26, 66, 99, 99, 99, 99,
+             24, 26, 56, 99, 99, 99, 99, 99, 47, 66, 99, 99, 99, 99, 99, 99] + [99] * 32
+
+_DC_LUMA_BITS = [0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0]
+_DC_CHROMA_BITS = [0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0]
+_DC_VALUES = list(range(12))
+_AC_LUMA_BITS = [0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d]
+_AC_CHROMA_BITS = [0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77]
+_AC_LUMA_VALUES = bytes.fromhex(
+    "01020300041105122131410613516107227114328191a1082342b1c11552d1f02433627282090a161718191a25262728292a3435363738393a"
+    "434445464748494a535455565758595a636465666768696a737475767778797a838485868788898a92939495969798999aa2a3a4a5a6a7a8a9aa"
+    "b2b3b4b5b6b7b8b9bac2c3c4c5c6c7c8c9cad2d3d4d5d6d7d8d9dae1e2e3e4e5e6e7e8e9eaf1f2f3f4f5f6f7f8f9fa")
+_AC_CHROMA_VALUES = bytes.fromhex(
+    "000102031104052131061241510761711322328108144291a1b1c109233352f0156272d10a162434e125f11718191a262728292a35363738393a"
+    "434445464748494a535455565758595a636465666768696a737475767778797a82838485868788898a92939495969798999aa2a3a4a5a6a7a8a9aa"
+    "b2b3b4b5b6b7b8b9bac2c3c4c5c6c7c8c9cad2d3d4d5d6d7d8d9dae2e3e4e5e6e7e8e9eaf2f3f4f5f6f7f8f9fa")
+
+_ZIGZAG = [0, 1, 8, 16, 9, 2, 3, 10, 17, 24, 32, 25, 18, 11, 4, 5, 12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6, 7, 14, 21,
+           28, 35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51, 58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61,
+           54, 47, 55, 62, 63]
+
+
+def _huff_codes(bits, values):
+    codes, code, k = {}, 0, 0
+    for length in range(1, 17):
+        for _ in range(bits[length - 1]):
+            codes[values[k]] = (code, length)
+            code += 1
+            k += 1
+        code <<= 1
+    return codes
+
+
+_DC_LUMA = _huff_codes(_DC_LUMA_BITS, _DC_VALUES)
+_DC_CHROMA = _huff_codes(_DC_CHROMA_BITS, _DC_VALUES)
+_EOB_LUMA = _huff_codes(_AC_LUMA_BITS, _AC_LUMA_VALUES)[0x00]
+_EOB_CHROMA = _huff_codes(_AC_CHROMA_BITS, _AC_CHROMA_VALUES)[0x00]
+
+
+class _BitWriter:
+    def __init__(self):
+        self.out = bytearray()
+        self.acc = 0
+        self.n = 0
+
+    def put(self, code, length):
+        self.acc = (self.acc << length) | (code & ((1 << length) - 1))
+        self.n += length
+        while self.n >= 8:
+            self.n -= 8
+            byte = (self.acc >> self.n) & 0xFF
+            self.out.append(byte)
+            if byte == 0xFF:
+                self.out.append(0x00)  # Byte stuffing
+        self.acc &= (1 << self.n) - 1
+
+    def flush(self):
+        if self.n:
+            self.put(0x7F, 8 - self.n)  # Pad with 1-bits
+
+
+def _segment(marker, payload):
+    return struct.pack(">BBH", 0xFF, marker, len(payload) + 2) + payload
+
+
+def _scaled_table(table, quality):
+    scale = 5000 // quality if quality < 50 else 200 - quality * 2
+    return [min(255, max(1, (q * scale + 50) // 100)) for q in table]
+
+
+def encode(width, height, cell_rgb, quality=75, pad_to=0):
+    """Encode an image whose colour is constant per 16x16 cell.
+
+    cell_rgb(cx, cy) -> (r, g, b) for cell column cx, row cy.
+    pad_to: grow the file to at least this many bytes with COM segments.
+    """
+    lq = _scaled_table(_LUMA_Q, quality)
+    cq = _scaled_table(_CHROMA_Q, quality)
+
+    head = bytearray(b"\xFF\xD8")
+    head += _segment(0xE0, b"JFIF\x00\x01\x01\x00\x00\x01\x00\x01\x00\x00")
+    head += _segment(0xDB, bytes([0]) + bytes(lq[i] for i in _ZIGZAG) + bytes([1]) + bytes(cq[i] for i in _ZIGZAG))
+    head += _segment(0xC0, struct.pack(">BHHB", 8, height, width, 3) + bytes([1, 0x22, 0, 2, 0x11, 1, 3, 0x11, 1]))
+    for cls_id, bits, values in ((0x00, _DC_LUMA_BITS, _DC_VALUES), (0x10, _AC_LUMA_BITS, _AC_LUMA_VALUES),
+                                 (0x01, _DC_CHROMA_BITS, _DC_VALUES), (0x11, _AC_CHROMA_BITS, _AC_CHROMA_VALUES)):
+        head += _segment(0xC4, bytes([cls_id]) + bytes(bits) + bytes(values))
+
+    bw = _BitWriter()
+    prev = [0, 0, 0]
+
+    def put_dc(comp, value, q, table, eob):
+        coef = int(round(8 * (value - 128) / q))
+        diff = coef - prev[comp]
+        prev[comp] = coef
+        size = abs(diff).bit_length()
+        code, length = table[size]
+        bw.put(code, length)
+        if size:
+            bw.put(diff if diff > 0 else diff + (1 << size) - 1, size)
+        bw.put(*eob)
+
+    for my in range((height + 15) // 16):
+        for mx in range((width + 15) // 16):
+            r, g, b = cell_rgb(mx, my)
+            y = 0.299 * r + 0.587 * g + 0.114 * b
+            cb = 128 - 0.168736 * r - 0.331264 * g + 0.5 * b
+            cr = 128 + 0.5 * r - 0.418688 * g - 0.081312 * b
+            for _ in range(4):
+                put_dc(0, y, lq[0], _DC_LUMA, _EOB_LUMA)
+            put_dc(1, cb, cq[0], _DC_CHROMA, _EOB_CHROMA)
+            put_dc(2, cr, cq[0], _DC_CHROMA, _EOB_CHROMA)
+    bw.flush()
+
+    body = bytes(bw.out)
+    scan = _segment(0xDA, bytes([3, 1, 0x00, 2, 0x11, 3, 0x11, 0, 63, 0]))
+    tail = b"\xFF\xD9"
+
+    pad = bytearray()
+    missing = pad_to - (len(head) + len(scan) + len(body) + len(tail))
+    filler = hashlib.sha256(b"pad").digest() * 2048
+    while missing > 4:
+        n = min(missing - 4, 65533)
+        pad += _segment(0xFE, filler[:n])
+        missing -= n + 4
+    # Padding sits after APP0 (JFIF stays first) and before the frame header,
+    # so decoders must skip it before they learn the image size
+    return bytes(head[:20]) + bytes(pad) + bytes(head[20:]) + scan + body + tail
+
+
+def cover(seed, size, pad_to=0):
+    """Deterministic flat-shaded 'album cover' for an image id."""
+    h = hashlib.sha256(seed.encode()).digest()
+    c1, c2, c3 = h[0:3], h[3:6], h[6:9]
+    cells = (size + 15) // 16
+
+    def cell_rgb(cx, cy):
+        ring = max(abs(cx - cells // 2), abs(cy - cells // 2)) * 8 // max(cells, 1)
+        base = (c1, c2, c3)[(ring + (cx * h[9] + cy * h[10]) // 97) % 3]
+        return tuple(int(v * (0.55 + 0.45 * (ring % 4) / 3)) for v in base)
+
+    return encode(size, size, cell_rgb, pad_to=pad_to)
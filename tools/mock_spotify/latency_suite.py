@@ -0,0 +1,296 @@
+#!/usr/bin/env python3
+"""End-to-end latency and fault-injection suite against mock_server.
+
+Host mode (default) launches the native firmware build with all traffic
+pointed at an in-process mock, drives the buttons over stdin and times each
+step against the mock's request log (one clock for both sides):
+
+    pio run -e native
+    python3 tools/mock_spotify/latency_suite.py --firmware .pio/build/native/program
+
+Device mode serves the mock for a real device on the LAN and reports what it
+observes passively (poll cadence, per-endpoint latency, connection reuse);
+press buttons on the device while it runs:
+
+    python3 tools/mock_spotify/latency_suite.py --device --bind 0.0.0.0 --port 8443 \\
+        --tls-cert cert.pem --tls-key key.pem --public-base https://<lan-ip>:8443 --duration 120
+
+Exits non-zero if any scenario's expectation fails.
+"""
+
+import argparse
+import os
+import queue
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+import mock_server
+
+PIN_PREV, PIN_PLAY, PIN_NEXT = 12, 13, 14
+NEXT = ("POST /v1/me/player/next",)
+
+
+def pct(values, p):
+    if not values:
+        return float("nan")
+    s = sorted(values)
+    k = (len(s) - 1) * p / 100
+    lo = int(k)
+    hi = min(lo + 1, len(s) - 1)
+    return s[lo] + (s[hi] - s[lo]) * (k - lo)
+
+
+def fmt_ms(values):
+    if not values:
+        return "n=0"
+    return (f"n={len(values):<3} p50={pct(values, 50):7.1f}  p95={pct(values, 95):7.1f}  "
+            f"max={max(values):7.1f} ms")
+
+
+class Firmware:
+    """Native firmware process: stdin for buttons, stdout captured with timestamps."""
+
+    def __init__(self, path, origin, clock):
+        self.clock = clock
+        self.lines = queue.Queue()
+        self.prefs = tempfile.NamedTemporaryFile(prefix="spotifything-prefs-", delete=False)
+        env = dict(os.environ, NATIVE_HTTP_ORIGIN=origin, NATIVE_PREFS_FILE=self.prefs.name)
+        self.proc = subprocess.Popen([path], stdin=subprocess.PIPE, stdout=subprocess.PIPE,
+                                     stderr=subprocess.STDOUT, env=env, text=True, bufsize=1)
+        threading.Thread(target=self._pump, daemon=True).start()
+
+    def _pump(self):
+        for line in self.proc.stdout:
+            self.lines.put((self.clock(), line.rstrip("\n")))
+
+    def send(self, line):
+        self.proc.stdin.write(line + "\n")
+        self.proc.stdin.flush()
+
+    def wait_for(self, text, timeout):
+        deadline = time.monotonic() + timeout
+        while time.monotonic() < deadline:
+            try:
+                t, line = self.lines.get(timeout=0.1)
+            except queue.Empty:
+                continue
+            if text in line:
+                return t
+        return None
+
+    def hold(self, pin, ms):
+        """Press and release; returns the release time (Button2 taps fire on release)."""
+        self.send(f"!pin {pin} 0")
+        time.sleep(ms / 1000)
+        t = self.clock()
+        self.send(f"!pin {pin} 1")
+        return t
+
+    def tap(self, pin):
+        return self.hold(pin, 80)
+
+    def stop(self):
+        try:
+            self.send("!quit")
+            self.proc.wait(timeout=3)
+        except Exception:
+            self.proc.kill()
+        os.unlink(self.prefs.name)
+
+
+class Suite:
+    def __init__(self, server):
+        self.server = server
+        self.state = server.state
+        self.results = []
+        self.failures = []
+
+    def clock(self):
+        return time.monotonic() - self.state.start
+
+    def events(self):
+        with self.state.lock:
+            return list(self.state.events)
+
+    @staticmethod
+    def received(e):
+        return e["t"] - e["ms"] / 1000  # Log time is after the response went out
+
+    def wait_event(self, since, match, timeout=10.0):
+        """First logged request after time `since` satisfying match(e)."""
+        deadline = time.monotonic() + timeout
+        while time.monotonic() < deadline:
+            for e in self.events():
+                if self.received(e) >= since and match(e):
+                    return e
+            time.sleep(0.01)
+        return None
+
+    def record(self, name, values, note=""):
+        self.results.append((name, values, note))
+
+    def expect(self, ok, message):
+        if not ok:
+            self.failures.append(message)
+        return ok
+
+    @staticmethod
+    def is_poll(e):
+        return e["method"] == "GET" and e["path"] == "/v1/me/player"
+
+    def poll_stats(self, t0, t1, label):
+        polls = [self.received(e) for e in self.events() if self.is_poll(e) and t0 <= self.received(e) < t1]
+        gaps = [(b - a) * 1000 for a, b in zip(polls, polls[1:])]
+        self.record(f"{label}: poll interval", gaps)
+        served = [e["ms"] for e in self.events() if self.is_poll(e) and t0 <= self.received(e) < t1]
+        self.record(f"{label}: poll server time", served)
+
+    def command_latency(self, fw, label, pin, paths, count=5, gap=1.5, hold_ms=80):
+        """paths: "METHOD /path" strings, any of which counts as the command."""
+        to_server, to_state = [], []
+        for _ in range(count):
+            t = fw.hold(pin, hold_ms)
+            cmd = self.wait_event(t, lambda e: f'{e["method"]} {e["path"]}' in paths)
+            if not self.expect(cmd is not None, f"{label}: {' / '.join(paths)} never arrived"):
+                continue
+            to_server.append((self.received(cmd) - t) * 1000)
+            poll = self.wait_event(self.received(cmd), lambda e: self.is_poll(e) and e["status"] == 200)
+            if poll:
+                to_state.append((poll["t"] - t) * 1000)
+            time.sleep(gap)
+        self.record(f"{label}: press -> command at server", to_server)
+        self.record(f"{label}: press -> fresh state served", to_state)
+
+    # --- Host scenarios ---
+    def run_host(self, firmware_path, origin):
+        fw = Firmware(firmware_path, origin, self.clock)
+        try:
+            t_launch = self.clock()
+            t_ready = fw.wait_for("Setup Complete", 30)
+            if not self.expect(t_ready is not None, "firmware never finished setup"):
+                return
+            first = self.wait_event(t_launch, self.is_poll)
+            if first:
+                self.record("boot: launch -> first poll", [(self.received(first) - t_launch) * 1000])
+
+            t0 = self.clock()
+            time.sleep(10)
+            self.poll_stats(t0, self.clock(), "idle")
+            with self.state.lock:
+                conns_before = self.state.connections
+
+            self.command_latency(fw, "next", PIN_NEXT, NEXT)
+            self.command_latency(fw, "play/pause", PIN_PLAY, ("PUT /v1/me/player/play", "PUT /v1/me/player/pause"))
+            # Smart previous: restarts the track (seek) once it is past 10s
+            self.command_latency(fw, "prev", PIN_PREV, ("POST /v1/me/player/previous", "PUT /v1/me/player/seek"),
+                                 count=3)
+
+            # Volume: hold NEXT ~2.5s, then see what level the server ends up at
+            with self.state.lock:
+                self.state.volume = 50
+            t = self.clock()
+            fw.hold(PIN_NEXT, 2500)
+            time.sleep(2)
+            vols = [e for e in self.events() if self.received(e) >= t and e["path"] == "/v1/me/player/volume"]
+            with self.state.lock:
+                final = self.state.volume
+            self.record("volume hold 2.5s", [e["ms"] for e in vols], f"{len(vols)} PUTs, final volume {final}")
+            self.expect(final > 50, "volume hold did not raise the volume")
+
+            # Like: hold PLAY past the 3s threshold
+            t = fw.hold(PIN_PLAY, 3500)
+            like = self.wait_event(t - 0.6, lambda e: e["path"] == "/v1/me/tracks")
+            self.expect(like is not None, "like: PUT /v1/me/tracks never arrived")
+
+            # 401 mid-session: time until polling is healthy again
+            with self.state.lock:
+                self.state.faults.append(mock_server.Fault("/v1/me/player", 401, method="GET"))
+            t = self.clock()
+            ok = self.wait_event(t, lambda e: self.is_poll(e) and e["status"] == 200 and not e["fault"], timeout=15)
+            if self.expect(ok is not None, "401: never recovered"):
+                self.record("401 -> next good poll", [(self.received(ok) - t) * 1000])
+
+            # 429 with Retry-After: how many polls land during the back-off window
+            with self.state.lock:
+                self.state.faults.append(mock_server.Fault("/v1/me/player", 429, count=1, retry_after=3))
+            t = self.clock()
+            time.sleep(3)
+            during = [e for e in self.events() if self.is_poll(e) and self.received(e) >= t]
+            self.record("429 (Retry-After 3s)", [], f"{len(during)} polls during back-off window")
+
+            # No active device: 204 polls, then PLAY must retry with device_id
+            with self.state.lock:
+                self.state.active = False
+            time.sleep(2)
+            t = fw.tap(PIN_PLAY)
+            retry = self.wait_event(t, lambda e: e["path"].startswith("/v1/me/player/p") and "device_id=" in e["query"])
+            self.expect(retry is not None, "no device: command never retried with device_id")
+            if retry:
+                self.record("no device: press -> device_id retry", [(self.received(retry) - t) * 1000])
+
+            # Slow network
+            with self.state.lock:
+                self.state.profiles["api"].update(latency_ms=250, jitter_ms=50)
+            self.command_latency(fw, "next @250ms RTT", PIN_NEXT, NEXT, count=4, gap=2)
+            with self.state.lock:
+                self.state.profiles["api"].clear()
+
+            with self.state.lock:
+                conns = self.state.connections
+                reqs = len(self.state.events)
+            self.record("connections", [], f"{conns} TCP connections for {reqs} requests "
+                                           f"({conns - conns_before} after boot+idle)")
+        finally:
+            fw.stop()
+
+    # --- Device scenario ---
+    def run_device(self, duration):
+        print(f"Serving for {duration}s; press buttons on the device now.")
+        t0 = self.clock()
+        time.sleep(duration)
+        self.poll_stats(t0, self.clock(), "device")
+        by_path = {}
+        for e in self.events():
+            by_path.setdefault(f'{e["method"]} {e["path"]}', []).append(e["ms"])
+        for key, values in sorted(by_path.items()):
+            self.record(f"server time {key}", values)
+        with self.state.lock:
+            self.record("connections", [], f"{self.state.connections} for {len(self.state.events)} requests")
+
+    def report(self):
+        print("\n=== Latency report ===")
+        for name, values, note in self.results:
+            line = f"{name:<44} {fmt_ms(values) if values else ''}"
+            print(f"{line}  {note}".rstrip())
+        if self.failures:
+            print("\nFAILURES:")
+            for f in self.failures:
+                print("  - " + f)
+        return not self.failures
+
+
+def main():
+    p = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    p.add_argument("--firmware", default=".pio/build/native/program")
+    p.add_argument("--device", action="store_true", help="serve a real device instead of launching the host build")
+    p.add_argument("--duration", type=int, default=60, help="device mode observation time (s)")
+    ours, rest = p.parse_known_args()
+    margs = mock_server.parse_args(rest + ([] if any(a.startswith("--port") for a in rest) else ["--port", "0"]))
+
+    server = mock_server.MockServer(margs).start_background()
+    host, port = server.server_address[:2]
+    suite = Suite(server)
+    if ours.device:
+        suite.run_device(ours.duration)
+    else:
+        suite.run_host(ours.firmware, f"{host}:{port}")
+    ok = suite.report()
+    server.shutdown()
+    sys.exit(0 if ok else 1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,482 @@
+#!/usr/bin/env python3
+"""Local stand-in for the Spotify Web API, the token relay and the image CDN.
+
+Serves realistic /v1/me/player payloads (including the large available_markets
+arrays), the playback command endpoints, /refresh + /login like the relay at
+`authurl`, and generated JPEG covers. Latency, jitter and bandwidth are
+configurable per host class, and faults (204/401/403/404/429/5xx) can be
+injected from the command line or at runtime. Every Nth player state and cover
+goes out chunked, without Content-Length, as the real services may send them.
+
+Routing is by path, so one server can stand in for every host:
+  /v1/...            Web API          (api.spotify.com)
+  /refresh, /login   token relay      (authurl)
+  /image/<id>        cover art        (i.scdn.co)
+  /__mock/...        control plane    (stats, log, faults, state, config)
+
+Host build:   NATIVE_HTTP_ORIGIN=127.0.0.1:8321 .pio/build/native/program
+Real device:  build with -D SPOTIFY_API_BASE=\\"https://<lan-ip>:8443\\" and
+              -D SPOTIFY_AUTH_URL=\\"https://<lan-ip>:8443/\\", run this with
+              --port 8443 --tls-cert cert.pem --tls-key key.pem
+              --public-base https://<lan-ip>:8443
+"""
+
+import argparse
+import hashlib
+import itertools
+import json
+import random
+import socket
+import ssl
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import parse_qs, urlsplit
+
+import jpeg
+
+# ISO 3166 codes Spotify lists per track/album; real payloads carry ~185 of them
+MARKETS = ("AD AE AG AL AM AO AR AT AU AZ BA BB BD BE BF BG BH BI BJ BN BO BR BS BT BW BY BZ CA CD CG CH CI CL CM "
+           "CO CR CV CW CY CZ DE DJ DK DM DO DZ EC EE EG ES ET FI FJ FM FR GA GB GD GE GH GM GN GQ GR GT GW GY HK HN "
+           "HR HT HU ID IE IL IN IQ IS IT JM JO JP KE KG KH KI KM KN KR KW KZ LA LB LC LI LK LR LS LT LU LV LY MA MC "
+           "MD ME MG MH MK ML MN MO MR MT MU MV MW MX MY MZ NA NE NG NI NL NO NP NR NZ OM PA PE PG PH PK PL PR PS PT "
+           "PW PY QA RO RS RW SA SB SC SE SG SI SK SL SM SN SR ST SV SZ TD TG TH TJ TL TN TO TR TT TV TW TZ UA UG US "
+           "UY UZ VC VE VN VU WS XK ZA ZM ZW").split()
+
+# Cover variants as Spotify serves them: (width, id prefix, typical CDN bytes)
+IMAGE_SIZES = ((640, "ab67616d0000b273", 110_000), (300, "ab67616d00001e02", 30_000), (64, "ab67616d00004851", 3_000))
+
+TITLES = ["Midnight City", "Dreams", "Hey Jude", "Bohemian Rhapsody",
+          "A Very Long Song Title That Will Not Fit In The Left Hand Text Pane At All (Remastered 2011)",
+          "Ça plane pour moi", "Déjà Vu", "夜に駆ける", "Señorita", "Smells Like Teen Spirit",
+          "Страх", "Blinding Lights"]
+ARTISTS = ["M83", "Fleetwood Mac", "The Beatles", "Queen", "The Extremely Long Named Orchestra And Choir Of Somewhere",
+           "Plastic Bertrand", "Olivia Rodrigo", "YOASOBI", "Shawn Mendes", "Nirvana", "Кино", "The Weeknd"]
+
+
+def make_tracks(count):
+    tracks = []
+    for i in range(count):
+        album_id = hashlib.sha1(f"album{i // 2}".encode()).hexdigest()  # Pairs of tracks share an album
+        tracks.append({
+            "id": hashlib.sha1(f"track{i}".encode()).hexdigest()[:22],
+            "name": TITLES[i % len(TITLES)],
+            "artist": ARTISTS[i % len(ARTISTS)],
+            "album": f"Album {i // 2}: " + TITLES[(i + 3) % len(TITLES)],
+            "album_id": album_id,
+            "duration_ms": 150_000 + (i * 37_000) % 180_000,
+        })
+    return tracks
+
+
+class Fault:
+    def __init__(self, path, status, count=1, method=None, retry_after=None, delay_ms=0):
+        self.path, self.status, self.count = path, int(status), int(count)
+        self.method, self.retry_after, self.delay_ms = method, retry_after, int(delay_ms)
+
+    @classmethod
+    def parse(cls, spec):
+        """PATH:STATUS[:COUNT[:RETRY_AFTER]] e.g. /v1/me/player:429:3:2"""
+        parts = spec.split(":")
+        return cls(parts[0], parts[1], parts[2] if len(parts) > 2 else 1,
+                   retry_after=parts[3] if len(parts) > 3 else None)
+
+
+class MockState:
+    """Playback model plus counters; every field is guarded by lock."""
+
+    def __init__(self, args):
+        self.lock = threading.Lock()
+        self.args = args
+        self.tracks = make_tracks(args.tracks)
+        self.index = 0
+        self.position_ms = 0
+        self.position_at = time.monotonic()
+        self.is_playing = True
+        self.volume = 50
+        self.active = True
+        self.device_id = "mockdevice0001"
+        self.liked = set()
+        self.tokens = {}  # token -> expiry (monotonic)
+        self.token_seq = itertools.count(1)
+        self.faults = [Fault.parse(f) for f in args.fault]
+        self.profiles = {"api": {}, "auth": {}, "image": {}}
+        self.images = {}
+        self.served = {"player": 0, "image": 0}
+        self.connections = 0
+        self.events = []
+        self.start = time.monotonic()
+
+    # --- Playback model ---
+    def progress(self):
+        pos = self.position_ms
+        if self.is_playing:
+            pos += int((time.monotonic() - self.position_at) * 1000)
+        dur = self.tracks[self.index]["duration_ms"]
+        if pos >= dur:  # Natural rollover
+            self.index = (self.index + 1) % len(self.tracks)
+            self.position_ms, self.position_at = pos - dur, time.monotonic()
+            return self.progress()
+        return pos
+
+    def set_position(self, ms):
+        self.position_ms, self.position_at = ms, time.monotonic()
+
+    def skip(self, delta):
+        self.progress()
+        self.index = (self.index + delta) % len(self.tracks)
+        self.set_position(0)
+        self.is_playing = True
+
+    def image_url(self, album_id, prefix):
+        return f"{self.args.public_base}/image/{prefix}{album_id[:24]}"
+
+    def track_json(self, t):
+        album = {
+            "album_type": "album",
+            "available_markets": MARKETS,
+            "id": t["album_id"][:22],
+            "images": [{"height": w, "width": w, "url": self.image_url(t["album_id"], p)} for w, p, _ in IMAGE_SIZES],
+            "name": t["album"],
+            "release_date": "2011-01-01",
+            "total_tracks": 12,
+            "type": "album",
+            "uri": "spotify:album:" + t["album_id"][:22],
+        }
+        return {
+            "album": album,
+            "artists": [{"id": "artist" + t["id"][:16], "name": t["artist"], "type": "artist"}],
+            "available_markets": MARKETS,
+            "disc_number": 1,
+            "duration_ms": t["duration_ms"],
+            "explicit": False,
+            "external_ids": {"isrc": "GBAYE0601498"},
+            "id": t["id"],
+            "is_local": False,
+            "name": t["name"],
+            "popularity": 71,
+            "track_number": 3,
+            "type": "track",
+            "uri": "spotify:track:" + t["id"],
+        }
+
+    def player_json(self):
+        progress = self.progress()
+        return {
+            "device": {"id": self.device_id, "is_active": True, "name": "Mock Speaker", "type": "Speaker",
+                       "volume_percent": self.volume, "supports_volume": True},
+            "shuffle_state": False,
+            "repeat_state": "off",
+            "timestamp": int(time.time() * 1000),
+            "context": {"type": "album", "uri": "spotify:album:mock"},
+            "progress_ms": progress,
+            "item": self.track_json(self.tracks[self.index]),
+            "currently_playing_type": "track",
+            "actions": {"disallows": {"resuming": True}},
+            "is_playing": self.is_playing,
+        }
+
+    def queue_json(self):
+        self.progress()
+        upcoming = [self.tracks[(self.index + i) % len(self.tracks)] for i in range(1, 21)]
+        return {
+            "currently_playing": self.track_json(self.tracks[self.index]),
+            "queue": [self.track_json(t) for t in upcoming],
+        }
+
+    def image(self, image_id):
+        if image_id not in self.images:
+            width, size = 300, 30_000
+            for w, prefix, nbytes in IMAGE_SIZES:
+                if image_id.startswith(prefix):
+                    width, size = w, nbytes
+            self.images[image_id] = jpeg.cover(image_id, width, pad_to=size if self.args.realistic_art else 0)
+        return self.images[image_id]
+
+    def chunked(self, kind):
+        """True for every --chunked-every'th response of this kind (player / image)"""
+        self.served[kind] += 1
+        every = self.args.chunked_every
+        return every > 0 and self.served[kind] % every == 0
+
+    def take_fault(self, method, path):
+        for f in self.faults:
+            if f.count > 0 and path.startswith(f.path) and (f.method is None or f.method == method):
+                f.count -= 1
+                return f
+        return None
+
+    def log(self, **event):
+        event["t"] = round(time.monotonic() - self.start, 4)
+        self.events.append(event)
+
+
+def host_class(path):
+    if path.startswith("/image/"):
+        return "image"
+    if path.startswith("/refresh") or path.startswith("/login"):
+        return "auth"
+    return "api"
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"  # Keep-alive, like the real services
+    server_version = "MockSpotify/1.0"
+
+    def log_message(self, fmt, *args):
+        if self.server.state.args.verbose:
+            super().log_message(fmt, *args)
+
+    def setup(self):
+        super().setup()
+        with self.server.state.lock:
+            self.server.state.connections += 1
+            self.conn_id = self.server.state.connections
+
+    def do_GET(self):
+        self.handle_any("GET")
+
+    def do_POST(self):
+        self.handle_any("POST")
+
+    def do_PUT(self):
+        self.handle_any("PUT")
+
+    # --- Plumbing ---
+    def handle_any(self, method):
+        t0 = time.monotonic()
+        state = self.server.state
+        url = urlsplit(self.path)
+        query = {k: v[0] for k, v in parse_qs(url.query).items()}
+        length = int(self.headers.get("Content-Length") or 0)
+        body = self.rfile.read(length) if length else b""
+        cls = host_class(url.path)
+
+        with state.lock:
+            fault = None if url.path.startswith("/__mock") else state.take_fault(method, url.path)
+            profile = {**vars(state.args.profile), **state.profiles[cls]}
+        if fault:
+            status, headers, payload = self.fault_response(fault)
+            time.sleep(fault.delay_ms / 1000)
+        else:
+            status, headers, payload = self.route(method, url.path, query, body)
+
+        delay = profile["latency_ms"] + random.uniform(-1, 1) * profile["jitter_ms"]
+        if delay > 0:
+            time.sleep(delay / 1000)
+        self.send(status, headers, payload, profile["bandwidth_kbps"])
+
+        if not url.path.startswith("/__mock"):
+            with state.lock:
+                state.log(method=method, path=url.path, query=url.query, status=status, conn=self.conn_id,
+                          host=cls, bytes=len(payload), ms=round((time.monotonic() - t0) * 1000, 2),
+                          fault=bool(fault))
+
+    def send(self, status, headers, payload, bandwidth_kbps):
+        chunked = headers.pop("Transfer-Encoding", None) == "chunked" and status != 204
+        self.send_response(status)
+        for k, v in headers.items():
+            self.send_header(k, v)
+        if chunked:
+            self.send_header("Transfer-Encoding", "chunked")
+        elif status != 204:
+            self.send_header("Content-Length", str(len(payload)))
+        self.end_headers()
+        if status == 204 or not payload:
+            if chunked:
+                self.wfile.write(b"0\r\n\r\n")
+            return
+        if bandwidth_kbps <= 0 and not chunked:
+            self.wfile.write(payload)
+            return
+        chunk = 1460  # One TCP segment per write keeps pacing smooth
+        per_chunk = chunk / (bandwidth_kbps * 125) if bandwidth_kbps > 0 else 0  # kbit/s -> bytes/s
+        for i in range(0, len(payload), chunk):
+            data = payload[i:i + chunk]
+            self.wfile.write(b"%x\r\n%s\r\n" % (len(data), data) if chunked else data)
+            self.wfile.flush()
+            time.sleep(per_chunk)
+        if chunked:
+            self.wfile.write(b"0\r\n\r\n")
+
+    @staticmethod
+    def json_response(status, obj, extra=None):
+        return status, {"Content-Type": "application/json; charset=utf-8", **(extra or {})}, \
+            json.dumps(obj, ensure_ascii=False).encode()
+
+    def fault_response(self, fault):
+        headers = {}
+        if fault.retry_after is not None:
+            headers["Retry-After"] = str(fault.retry_after)
+        if fault.status == 204:
+            return 204, headers, b""
+        if fault.status == 401:
+            with self.server.state.lock:
+                self.server.state.tokens.clear()  # Token really is dead now
+            message = "The access token expired"
+        else:
+            message = {403: "Player command failed: Restriction violated", 404: "Player command failed: No active device found",
+                       429: "API rate limit exceeded"}.get(fault.status, "Service unavailable")
+        return self.json_response(fault.status, {"error": {"status": fault.status, "message": message}}, headers)
+
+    # --- Endpoints ---
+    def authorized(self):
+        auth = self.headers.get("Authorization", "")
+        token = auth[7:] if auth.startswith("Bearer ") else ""
+        expiry = self.server.state.tokens.get(token)
+        return expiry is not None and expiry > time.monotonic()
+
+    def route(self, method, path, query, body):
+        state = self.server.state
+        if path.startswith("/__mock/"):
+            return self.control(method, path, query, body)
+        if path.startswith("/image/"):
+            with state.lock:
+                data = state.image(path[len("/image/"):])
+                headers = {"Content-Type": "image/jpeg", "Cache-Control": "max-age=31536000"}
+                if state.chunked("image"):
+                    headers["Transfer-Encoding"] = "chunked"
+            return 200, headers, data
+        if path == "/refresh":
+            with state.lock:
+                token = f"mock-token-{next(state.token_seq)}-" + "x" * 200  # Real tokens are ~250 chars
+                state.tokens[token] = time.monotonic() + state.args.token_ttl
+            return self.json_response(200, {"access_token": token, "token_type": "Bearer",
+                                            "expires_in": state.args.token_ttl})
+        if path == "/login":
+            return 200, {"Content-Type": "text/html"}, b"<html><body>Mock login: already authorised.</body></html>"
+
+        with state.lock:
+            if not self.authorized():
+                return self.json_response(401, {"error": {"status": 401, "message": "Invalid access token"}})
+
+            if path == "/v1/me/player" and method == "GET":
+                if not state.active:
+                    return 204, {}, b""
+                extra = {"Transfer-Encoding": "chunked"} if state.chunked("player") else None
+                return self.json_response(200, state.player_json(), extra)
+
+            if path == "/v1/me/player/queue" and method == "GET":
+                if not state.active:
+                    return 204, {}, b""
+                return self.json_response(200, state.queue_json())
+
+            if path == "/v1/me/tracks" and method == "PUT":
+                state.liked.update(filter(None, query.get("ids", "").split(",")))
+                return 200, {"Content-Length": "0"}, b""
+
+            commands = {
+                ("POST", "/v1/me/player/next"): lambda: state.skip(1),
+                ("POST", "/v1/me/player/previous"): lambda: state.skip(-1),
+                ("PUT", "/v1/me/player/play"): lambda: (state.set_position(state.progress()), setattr(state, "is_playing", True)),
+                ("PUT", "/v1/me/player/pause"): lambda: (state.set_position(state.progress()), setattr(state, "is_playing", False)),
+                ("PUT", "/v1/me/player/seek"): lambda: state.set_position(int(query.get("position_ms", 0))),
+                ("PUT", "/v1/me/player/volume"): lambda: setattr(state, "volume",
+                                                                 max(0, min(100, int(query.get("volume_percent", 50))))),
+            }
+            action = commands.get((method, path))
+            if action is None:
+                return self.json_response(404, {"error": {"status": 404, "message": "Service not found"}})
+            if not state.active:
+                if query.get("device_id") != state.device_id:
+                    return self.json_response(404, {"error": {"status": 404, "reason": "NO_ACTIVE_DEVICE",
+                                                              "message": "Player command failed: No active device found"}})
+                state.active = True  # Targeting the device by id wakes it
+            action()
+            return 204, {}, b""
+
+    def control(self, method, path, query, body):
+        state = self.server.state
+        data = json.loads(body or b"{}")
+        with state.lock:
+            if path == "/__mock/stats":
+                counts = {}
+                for e in state.events:
+                    key = f'{e["method"]} {e["path"]}'
+                    counts[key] = counts.get(key, 0) + 1
+                return self.json_response(200, {"connections": state.connections, "requests": len(state.events),
+                                                "by_endpoint": counts, "liked": sorted(state.liked)})
+            if path == "/__mock/log":
+                since = int(query.get("since", 0))
+                return self.json_response(200, {"next": len(state.events), "events": state.events[since:]})
+            if path == "/__mock/faults" and method == "POST":
+                state.faults.append(Fault(**data))
+                return 204, {}, b""
+            if path == "/__mock/state" and method == "POST":
+                for key in ("active", "is_playing", "volume"):
+                    if key in data:
+                        setattr(state, key, data[key])
+                if "track" in data:
+                    state.index = int(data["track"]) % len(state.tracks)
+                    state.set_position(0)
+                if "progress_ms" in data:
+                    state.set_position(int(data["progress_ms"]))
+                return 204, {}, b""
+            if path == "/__mock/config" and method == "POST":
+                state.profiles[data.pop("host", "api")].update(data)
+                return 204, {}, b""
+        return self.json_response(404, {"error": "unknown control endpoint"})
+
+
+class MockServer(ThreadingHTTPServer):
+    daemon_threads = True
+    allow_reuse_address = True
+
+    def __init__(self, args):
+        super().__init__((args.bind, args.port), Handler)
+        self.state = MockState(args)
+        if args.tls_cert:
+            ctx = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+            ctx.load_cert_chain(args.tls_cert, args.tls_key)
+            self.socket = ctx.wrap_socket(self.socket, server_side=True)
+
+    def server_bind(self):
+        self.socket.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        super().server_bind()
+
+    def start_background(self):
+        threading.Thread(target=self.serve_forever, daemon=True).start()
+        return self
+
+
+def build_parser():
+    p = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    p.add_argument("--bind", default="127.0.0.1")
+    p.add_argument("--port", type=int, default=8321)
+    p.add_argument("--public-base", default="https://i.scdn.co",
+                   help="origin used in image URLs (point at this server for a real device)")
+    p.add_argument("--tls-cert")
+    p.add_argument("--tls-key")
+    p.add_argument("--tracks", type=int, default=12)
+    p.add_argument("--token-ttl", type=int, default=3600, help="expires_in for issued tokens (s)")
+    p.add_argument("--latency-ms", type=float, default=0, help="added to every response")
+    p.add_argument("--jitter-ms", type=float, default=0, help="+/- uniform jitter on latency")
+    p.add_argument("--bandwidth-kbps", type=float, default=0, help="body throughput cap, 0 = unlimited")
+    p.add_argument("--no-realistic-art", dest="realistic_art", action="store_false",
+                   help="serve covers at their natural (tiny) size instead of CDN-sized files")
+    p.add_argument("--chunked-every", type=int, default=3, metavar="N",
+                   help="send every Nth player state and cover chunked, without Content-Length (0 = never)")
+    p.add_argument("--fault", action="append", default=[], metavar="PATH:STATUS[:COUNT[:RETRY_AFTER]]")
+    p.add_argument("-v", "--verbose", action="store_true")
+    return p
+
+
+def parse_args(argv=None):
+    args = build_parser().parse_args(argv)
+    args.profile = argparse.Namespace(latency_ms=args.latency_ms, jitter_ms=args.jitter_ms,
+                                      bandwidth_kbps=args.bandwidth_kbps)
+    return args
+
+
+def main():
+    args = parse_args()
+    server = MockServer(args)
+    print(f"Mock Spotify listening on {args.bind}:{args.port} ({'https' if args.tls_cert else 'http'})")
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()